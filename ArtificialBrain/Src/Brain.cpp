@@ -1,151 +1,643 @@
 #include "Brain.h"
+#include "GrowKernel.h"
+#include "Random.h"
+#include "ThreadPool.h"
 
-#include <random>
+#include <cmath>
+
+#include <algorithm>
+#include <new>
 
 constexpr auto PI = 3.1415926535897932384;
 
-std::mt19937                          s_RNG(std::random_device {}());
-std::uniform_real_distribution<float> s_ThetaDist(-PI, PI);
-std::uniform_real_distribution<float> s_GrowthDist(0.0001f, 0.01f);
+// Dendrites the scalar kernel keeps per step state for on the stack at once.
+constexpr size_t c_ScalarBlock = 64;
 
-Point operator+(Point lhs, Point rhs)
+static float ThetaFromUniform(float u)
 {
-	return { lhs.x + rhs.x, lhs.y + rhs.y };
+	return static_cast<float>(-PI + u * 2.0 * PI);
 }
 
-Point operator-(Point lhs, Point rhs)
+static float GrowthFromUniform(float u)
 {
-	return { lhs.x - rhs.x, lhs.y - rhs.y };
+	return 0.0001f + u * (0.01f - 0.0001f);
 }
 
-Point operator*(Point lhs, Point rhs)
+static void Direction(float dx, float dy, GrowthMode mode, float& c, float& s)
 {
-	return { lhs.x * rhs.x, lhs.y * rhs.y };
+	if (mode == GrowthMode::Trig)
+	{
+		float a = atan2f(dy, dx);
+		c       = cosf(a);
+		s       = sinf(a);
+	}
+	else
+	{
+		float l = sqrtf(dx * dx + dy * dy);
+		c       = l == 0.0f ? 1.0f : dx / l;
+		s       = l == 0.0f ? 0.0f : dy / l;
+	}
 }
 
-Point operator*(float lhs, Point rhs)
+template <size_t N>
+bool GrowNeurite(Point (&points)[N], float& currentLength, float maxLength, float growth, float dAngle)
 {
-	return { lhs * rhs.x, lhs * rhs.y };
+	float totalLength = currentLength;
+	growth            = std::min<float>(growth, maxLength - totalLength);
+	if (growth == 0.0f)
+		return false;
+	currentLength = growth == maxLength - totalLength ? maxLength : totalLength + growth;
+
+	float len = totalLength / (N - 1);
+	points[0] = { 0.0f, 0.0f };
+	if (GetGrowthMode() == GrowthMode::Vector)
+	{
+		for (size_t i = N - 1; i > 1; --i)
+			points[i - 1] = points[i] - direction(points[i] - points[i - 1]) * len;
+		for (size_t i = 1; i < N; ++i)
+			points[i] = points[i - 1] + direction(points[i] - points[i - 1]) * len;
+
+		Point dir     = rotate(direction(points[N - 1] - points[N - 2]), cosf(dAngle), sinf(dAngle));
+		points[N - 1] = points[N - 2] + dir * (len + growth);
+		return true;
+	}
+
+	float curAngle = angle(points[N - 1] - points[N - 2]);
+	for (size_t i = N - 1; i > 1; --i)
+	{
+		points[i - 1] = points[i] - fromAngle(curAngle) * len;
+		curAngle      = angle(points[i - 1] - points[i - 2]);
+	}
+	for (size_t i = 1; i < N; ++i)
+	{
+		curAngle  = angle(points[i] - points[i - 1]);
+		points[i] = points[i - 1] + fromAngle(curAngle) * len;
+	}
+
+	curAngle       = angle(points[N - 1] - points[N - 2]);
+	float newAngle = curAngle + dAngle;
+	points[N - 1]  = points[N - 2] + fromAngle(newAngle) * (len + growth);
+	return true;
 }
 
-Point operator*(Point lhs, float rhs)
+template bool GrowNeurite<8>(Point (&points)[8], float& length, float maxLength, float growth, float dAngle);
+template bool GrowNeurite<16>(Point (&points)[16], float& length, float maxLength, float growth, float dAngle);
+template bool GrowNeurite<32>(Point (&points)[32], float& length, float maxLength, float growth, float dAngle);
+template bool GrowNeurite<64>(Point (&points)[64], float& length, float maxLength, float growth, float dAngle);
+
+template <size_t D, size_t P>
+void InitNeuron(NeuronT<D, P>& neuron, Point pos, uint64_t seed, uint32_t id)
 {
-	return { lhs.x * rhs, lhs.y * rhs };
+	neuron.pos          = pos;
+	neuron.seed         = seed;
+	neuron.id           = id;
+	neuron.step         = 0;
+	neuron.longest      = 0;
+	neuron.furthest     = 0;
+	neuron.longestDist  = 0.0f;
+	neuron.furthestDist = 0.0f;
+
+	float maxLengthRandom[D];
+	float thetaRandom[D];
+	RandomUniformBatch(seed, id, c_RandomInitStep, 0, D, maxLengthRandom, thetaRandom);
+	for (size_t i = 0; i < D; ++i)
+	{
+		auto& dendrite = neuron.dendrites[i];
+		std::fill_n(dendrite.points, P - 1, Point { 0.0f, 0.0f });
+		dendrite.maxLength     = GrowthFromUniform(maxLengthRandom[i]) * 500;
+		dendrite.points[P - 1] = fromAngle(ThetaFromUniform(thetaRandom[i])) * dendrite.maxLength / 500;
+		dendrite.length        = length(dendrite.points[P - 1]);
+		neuron.tipDist[i]      = dendrite.length;
+		neuron.active[i]       = static_cast<uint32_t>(i);
+	}
+	neuron.activeCount = D;
+
+	for (size_t i = 0; i < D; ++i)
+	{
+		if (neuron.dendrites[i].maxLength > neuron.longestDist)
+		{
+			neuron.longestDist = neuron.dendrites[i].maxLength;
+			neuron.longest     = i;
+		}
+	}
 }
 
-Point operator/(Point lhs, Point rhs)
+template <size_t D, size_t P>
+size_t GrowNeuron(NeuronT<D, P>& neuron)
 {
-	return { lhs.x / rhs.x, lhs.y / rhs.y };
+	size_t segments = 0;
+	size_t kept     = 0;
+	for (size_t k = 0; k < neuron.activeCount; ++k)
+	{
+		uint32_t i        = neuron.active[k];
+		auto&    dendrite = neuron.dendrites[i];
+
+		float random[4];
+		RandomUniform(neuron.seed, neuron.id, i, neuron.step, random);
+		float speed = GrowthFromUniform(random[0]);
+		if (GrowNeurite(dendrite.points, dendrite.length, dendrite.maxLength, speed, ThetaFromUniform(random[1]) * 2.0f * speed))
+			segments += P - 1;
+
+		neuron.tipDist[i] = length(dendrite.points[P - 1]);
+		if (dendrite.length < dendrite.maxLength)
+			neuron.active[kept++] = i;
+	}
+	neuron.activeCount = kept;
+
+	neuron.furthest     = 0;
+	neuron.furthestDist = 0.0f;
+	for (size_t i = 0; i < D; ++i)
+	{
+		if (neuron.tipDist[i] > neuron.furthestDist)
+		{
+			neuron.furthestDist = neuron.tipDist[i];
+			neuron.furthest     = i;
+		}
+	}
+
+	auto& furthest  = neuron.dendrites[neuron.furthest];
+	bool  saturated = furthest.length >= furthest.maxLength;
+	float random[4];
+	RandomUniform(neuron.seed, neuron.id, c_RandomNeuronStream, neuron.step, random);
+	furthest.maxLength += GrowthFromUniform(random[0]);
+	furthest.maxLength  = std::min<float>(furthest.maxLength, 10.0f);
+	if (furthest.maxLength > neuron.longestDist)
+	{
+		neuron.longestDist = furthest.maxLength;
+		neuron.longest     = neuron.furthest;
+	}
+	if (saturated && furthest.length < furthest.maxLength)
+		neuron.active[neuron.activeCount++] = static_cast<uint32_t>(neuron.furthest);
+	++neuron.step;
+	return segments;
 }
 
-Point operator/(float lhs, Point rhs)
+template void   InitNeuron<64, 8>(NeuronT<64, 8>& neuron, Point pos, uint64_t seed, uint32_t id);
+template void   InitNeuron<256, 32>(NeuronT<256, 32>& neuron, Point pos, uint64_t seed, uint32_t id);
+template void   InitNeuron<1024, 64>(NeuronT<1024, 64>& neuron, Point pos, uint64_t seed, uint32_t id);
+template size_t GrowNeuron<64, 8>(NeuronT<64, 8>& neuron);
+template size_t GrowNeuron<256, 32>(NeuronT<256, 32>& neuron);
+template size_t GrowNeuron<1024, 64>(NeuronT<1024, 64>& neuron);
+
+static size_t GrowNeuritesScalarBlock(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode)
 {
-	return { lhs / rhs.x, lhs / rhs.y };
+	float len[c_ScalarBlock];
+	float tipGrowth[c_ScalarBlock];
+	bool  active[c_ScalarBlock];
+
+	const size_t stride = lanes.stride;
+	const size_t last   = lanes.points - 1;
+	float* const x      = lanes.x;
+	float* const y      = lanes.y;
+	auto         X      = [&](size_t i, size_t d) -> float& { return x[i * stride + d]; };
+	auto         Y      = [&](size_t i, size_t d) -> float& { return y[i * stride + d]; };
+
+	size_t grown = 0;
+	for (size_t d = begin; d < end; ++d)
+	{
+		size_t b         = d - begin;
+		float  remaining = lanes.maxLength[d] - lanes.length[d];
+		len[b]           = lanes.length[d] / static_cast<float>(last);
+		tipGrowth[b]     = std::min<float>(growth[d], remaining);
+		active[b]        = tipGrowth[b] != 0.0f;
+		grown           += active[b];
+		if (active[b])
+			lanes.length[d] = tipGrowth[b] == remaining ? lanes.maxLength[d] : lanes.length[d] + tipGrowth[b];
+	}
+	if (!grown)
+		return 0;
+
+	for (size_t d = begin; d < end; ++d)
+	{
+		if (!active[d - begin])
+			continue;
+		X(0, d) = 0.0f;
+		Y(0, d) = 0.0f;
+	}
+	for (size_t i = last; i > 1; --i)
+	{
+		for (size_t d = begin; d < end; ++d)
+		{
+			size_t b = d - begin;
+			if (!active[b])
+				continue;
+			float c, s;
+			Direction(X(i, d) - X(i - 1, d), Y(i, d) - Y(i - 1, d), mode, c, s);
+			X(i - 1, d) = X(i, d) - c * len[b];
+			Y(i - 1, d) = Y(i, d) - s * len[b];
+		}
+	}
+	for (size_t i = 1; i <= last; ++i)
+	{
+		for (size_t d = begin; d < end; ++d)
+		{
+			size_t b = d - begin;
+			if (!active[b])
+				continue;
+			float c, s;
+			Direction(X(i, d) - X(i - 1, d), Y(i, d) - Y(i - 1, d), mode, c, s);
+			X(i, d) = X(i - 1, d) + c * len[b];
+			Y(i, d) = Y(i - 1, d) + s * len[b];
+		}
+	}
+	for (size_t d = begin; d < end; ++d)
+	{
+		size_t b = d - begin;
+		if (!active[b])
+			continue;
+		float c, s;
+		if (mode == GrowthMode::Trig)
+		{
+			float newAngle = atan2f(Y(last, d) - Y(last - 1, d), X(last, d) - X(last - 1, d)) + dAngle[d];
+			c              = cosf(newAngle);
+			s              = sinf(newAngle);
+		}
+		else
+		{
+			float ux, uy;
+			Direction(X(last, d) - X(last - 1, d), Y(last, d) - Y(last - 1, d), mode, ux, uy);
+			float dc = cosf(dAngle[d]);
+			float ds = sinf(dAngle[d]);
+			c        = dc * ux - ds * uy;
+			s        = ds * ux + dc * uy;
+		}
+		X(last, d) = X(last - 1, d) + c * (len[b] + tipGrowth[b]);
+		Y(last, d) = Y(last - 1, d) + s * (len[b] + tipGrowth[b]);
+	}
+	return grown;
 }
 
-Point operator/(Point lhs, float rhs)
+size_t GrowNeuritesScalar(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode)
 {
-	return { lhs.x / rhs, lhs.y / rhs };
+	size_t grown = 0;
+	for (size_t d = begin; d < end; d += c_ScalarBlock)
+		grown += GrowNeuritesScalarBlock(lanes, growth, dAngle, d, std::min(d + c_ScalarBlock, end), mode);
+	return grown;
 }
 
-float length(Point p)
+static size_t PaddedStride(size_t dendrites)
 {
-	return sqrtf(p.x * p.x + p.y * p.y);
+	return (dendrites + c_NeuronLaneAlignment - 1) / c_NeuronLaneAlignment * c_NeuronLaneAlignment;
 }
 
-float angle(Point p)
+void NeuronSoA::AlignedDelete::operator()(float* data) const
 {
-	return atan2f(p.y, p.x);
+	::operator delete[](data, std::align_val_t { 64 });
 }
 
-Point fromAngle(float angle)
+NeuronSoA::NeuronSoA(NeuronShape shape)
+	: NeuronSoA(shape, false)
 {
-	return { cosf(angle), sinf(angle) };
+	Clear();
 }
 
-template <size_t N>
-void GrowNeurite(Point (&points)[N], float maxLength, float growth, float angleSpread)
+NeuronSoA::NeuronSoA(NeuronShape shape, bool)
+	: m_Shape(shape),
+	  m_Stride(PaddedStride(shape.dendrites)),
+	  m_Data(static_cast<float*>(::operator new[](DataSize() * sizeof(float), std::align_val_t { 64 })))
 {
-	float totalLength = 0.0f;
-	Point pPos        = points[0];
-	for (size_t i = 1; i < N; ++i)
+}
+
+NeuronSoA::NeuronSoA(const NeuronSoA& other)
+	: NeuronSoA(other.m_Shape, false)
+{
+	*this = other;
+}
+
+NeuronSoA NeuronSoA::Uninitialized(NeuronShape shape)
+{
+	return NeuronSoA(shape, false);
+}
+
+void NeuronSoA::Clear()
+{
+	std::fill_n(m_Data.get(), DataSize(), 0.0f);
+}
+
+NeuronSoA& NeuronSoA::operator=(const NeuronSoA& other)
+{
+	if (this == &other)
+		return *this;
+	if (!m_Data || m_Shape.dendrites != other.m_Shape.dendrites || m_Shape.points != other.m_Shape.points)
+		*this = Uninitialized(other.m_Shape);
+	std::copy_n(other.m_Data.get(), DataSize(), m_Data.get());
+	pos          = other.pos;
+	longest      = other.longest;
+	furthest     = other.furthest;
+	longestDist  = other.longestDist;
+	furthestDist = other.furthestDist;
+	activeBlocks  = other.activeBlocks;
+	blockFurthest = other.blockFurthest;
+	seed         = other.seed;
+	step         = other.step;
+	id           = other.id;
+	return *this;
+}
+
+void InitNeuron(NeuronSoA& neuron, Point pos, uint64_t seed, uint32_t id)
+{
+	const size_t dendrites = neuron.Dendrites();
+	const size_t last      = neuron.Points() - 1;
+
+	neuron.pos          = pos;
+	neuron.seed         = seed;
+	neuron.id           = id;
+	neuron.step         = 0;
+	neuron.longest      = 0;
+	neuron.furthest     = 0;
+	neuron.longestDist  = 0.0f;
+	neuron.furthestDist = 0.0f;
+	neuron.Clear();
+
+	float* maxLength = neuron.MaxLength();
+	float* theta     = neuron.DAngle();
+	float* tipX      = neuron.X(last);
+	float* tipY      = neuron.Y(last);
+	float* len       = neuron.Length();
+	float* tipDist   = neuron.TipDist();
+	RandomUniformBatch(seed, id, c_RandomInitStep, 0, dendrites, maxLength, theta);
+	for (size_t d = 0; d < dendrites; ++d)
 	{
-		Point delta  = points[i] - pPos;
-		pPos         = points[i];
-		totalLength += length(delta);
+		maxLength[d] = GrowthFromUniform(maxLength[d]) * 500;
+		theta[d]     = ThetaFromUniform(theta[d]);
+	}
+	for (size_t d = 0; d < dendrites; ++d)
+	{
+		tipX[d] = cosf(theta[d]) * maxLength[d] / 500;
+		tipY[d] = sinf(theta[d]) * maxLength[d] / 500;
+	}
+	for (size_t d = 0; d < dendrites; ++d)
+	{
+		len[d]     = sqrtf(tipX[d] * tipX[d] + tipY[d] * tipY[d]);
+		tipDist[d] = len[d];
 	}
-	growth = std::min<float>(growth, maxLength - totalLength);
-	if (growth == 0.0f)
-		return;
 
-	float len      = totalLength / (N - 1);
-	points[0]      = { 0.0f, 0.0f };
-	float curAngle = angle(points[N - 1] - points[N - 2]);
-	for (size_t i = N - 1; i > 1; --i)
+	for (size_t d = 0; d < dendrites; ++d)
 	{
-		points[i - 1] = points[i] - fromAngle(curAngle) * len;
-		curAngle      = angle(points[i - 1] - points[i - 2]);
+		if (maxLength[d] > neuron.longestDist)
+		{
+			neuron.longestDist = maxLength[d];
+			neuron.longest     = d;
+		}
 	}
-	for (size_t i = 1; i < N; ++i)
+
+	neuron.activeBlocks.resize((dendrites + c_NeuronLaneAlignment - 1) / c_NeuronLaneAlignment);
+	for (size_t block = 0; block < neuron.activeBlocks.size(); ++block)
+		neuron.activeBlocks[block] = static_cast<uint32_t>(block);
+	FindBlockFurthest(neuron);
+}
+
+// Turns the uniform draws in Growth and DAngle into growth and angle change.
+static void GrowthFromDraws(NeuronSoA& neuron, size_t begin, size_t end)
+{
+	float* growth = neuron.Growth();
+	float* dAngle = neuron.DAngle();
+	for (size_t d = begin; d < end; ++d)
 	{
-		curAngle  = angle(points[i] - points[i - 1]);
-		points[i] = points[i - 1] + fromAngle(curAngle) * len;
+		growth[d] = GrowthFromUniform(growth[d]);
+		dAngle[d] = ThetaFromUniform(dAngle[d]) * 2.0f * growth[d];
 	}
+}
 
-	curAngle       = angle(points[N - 1] - points[N - 2]);
-	float dAngle   = s_ThetaDist(s_RNG) * angleSpread;
-	float newAngle = curAngle + dAngle;
-	points[N - 1]  = points[N - 2] + fromAngle(newAngle) * (len + growth);
+static void DrawGrowth(NeuronSoA& neuron, size_t begin, size_t end)
+{
+	RandomUniformBatch(neuron.seed, neuron.id, neuron.step, begin, end, neuron.Growth(), neuron.DAngle());
+	GrowthFromDraws(neuron, begin, end);
+}
+
+void DrawGrowthScalar(NeuronSoA& neuron, size_t begin, size_t end)
+{
+	RandomUniformBatchScalar(neuron.seed, neuron.id, neuron.step, begin, end, neuron.Growth(), neuron.DAngle());
+	GrowthFromDraws(neuron, begin, end);
+}
+
+static bool IsBlockActive(const NeuronSoA& neuron, size_t block)
+{
+	const float* len       = neuron.Length();
+	const float* maxLength = neuron.MaxLength();
+	size_t       end       = std::min((block + 1) * c_NeuronLaneAlignment, neuron.Dendrites());
+	for (size_t d = block * c_NeuronLaneAlignment; d < end; ++d)
+	{
+		if (len[d] < maxLength[d])
+			return true;
+	}
+	return false;
 }
 
-void InitNeuron(Neuron& neuron)
+// Furthest tip among some dendrites, ties go to the lowest index like a forward scan would.
+struct alignas(64) TipPartial
 {
-	neuron.pos = { 0.0f, 0.0f };
-	for (size_t i = 0; i < 256; ++i)
+	size_t grown        = 0;
+	size_t furthest     = 0;
+	float  furthestDist = -1.0f;
+
+	void Merge(size_t d, float dist)
 	{
-		for (size_t j = 0; j < 32; ++j)
+		if (dist > furthestDist || (dist == furthestDist && d < furthest))
 		{
-			neuron.dendrites[i].points[j] = { 0.0f, 0.0f };
-			neuron.dendrites[i].maxLength = s_GrowthDist(s_RNG) * 500;
-			if (neuron.dendrites[i].maxLength > neuron.longestDist)
-			{
-				neuron.longestDist = neuron.dendrites[i].maxLength;
-				neuron.longest     = i;
-			}
+			furthestDist = dist;
+			furthest     = d;
 		}
 	}
+};
+
+// Set on an entry of activeBlocks whose dendrites all reached their maxLength during the step.
+constexpr uint32_t c_BlockSaturated = 0x80000000u;
 
-	for (size_t i = 0; i < 256; ++i)
-		neuron.dendrites[i].points[31] = fromAngle(s_ThetaDist(s_RNG)) * neuron.dendrites[i].maxLength / 500;
+static uint32_t BlockFurthest(const NeuronSoA& neuron, size_t block)
+{
+	const float* tipDist = neuron.TipDist();
+	size_t       begin   = block * c_NeuronLaneAlignment;
+	size_t       end     = std::min(begin + c_NeuronLaneAlignment, neuron.Dendrites());
+	size_t       best    = begin;
+	for (size_t d = begin + 1; d < end; ++d)
+	{
+		if (tipDist[d] > tipDist[best])
+			best = d;
+	}
+	return static_cast<uint32_t>(best);
 }
 
-float GrowthSpeed()
+void FindBlockFurthest(NeuronSoA& neuron)
 {
-	return (100.0f - (1.0f / s_GrowthDist(s_RNG))) * 0.0001f;
+	neuron.blockFurthest.resize((neuron.Dendrites() + c_NeuronLaneAlignment - 1) / c_NeuronLaneAlignment);
+	for (size_t block = 0; block < neuron.blockFurthest.size(); ++block)
+		neuron.blockFurthest[block] = BlockFurthest(neuron, block);
 }
 
-void GrowNeuron(Neuron& neuron)
+// Grows activeBlocks[first, last) and refreshes their tips, blockFurthest and partial. Blocks that
+// saturated are flagged with c_BlockSaturated for FinishStep to drop.
+static void GrowBlocks(NeuronSoA& neuron, size_t first, size_t last, TipPartial& partial)
 {
-	neuron.furthest     = 0;
-	neuron.furthestDist = 0.0f;
-	for (size_t i = 0; i < 256; ++i)
+	const float* x       = neuron.X(neuron.Points() - 1);
+	const float* y       = neuron.Y(neuron.Points() - 1);
+	float*       tipDist = neuron.TipDist();
+
+	for (size_t k = first; k < last; ++k)
+	{
+		size_t block = neuron.activeBlocks[k];
+		size_t begin = block * c_NeuronLaneAlignment;
+		size_t end   = std::min(begin + c_NeuronLaneAlignment, neuron.Dendrites());
+		DrawGrowth(neuron, begin, end);
+		partial.grown += GrowNeurites(neuron.Lanes(), neuron.Growth(), neuron.DAngle(), begin, end);
+		for (size_t d = begin; d < end; ++d)
+			tipDist[d] = length(Point { x[d], y[d] });
+
+		uint32_t furthest           = BlockFurthest(neuron, block);
+		neuron.blockFurthest[block] = furthest;
+		partial.Merge(furthest, tipDist[furthest]);
+		if (!IsBlockActive(neuron, block))
+			neuron.activeBlocks[k] |= c_BlockSaturated;
+	}
+}
+
+static void ExtendFurthest(NeuronSoA& neuron)
+{
+	float* maxLength = neuron.MaxLength();
+	bool   saturated = neuron.Length()[neuron.furthest] >= maxLength[neuron.furthest];
+	float  random[4];
+	RandomUniform(neuron.seed, neuron.id, c_RandomNeuronStream, neuron.step, random);
+	maxLength[neuron.furthest] += GrowthFromUniform(random[0]);
+	maxLength[neuron.furthest]  = std::min<float>(maxLength[neuron.furthest], 10.0f);
+	if (maxLength[neuron.furthest] > neuron.longestDist)
 	{
-		float speed = s_GrowthDist(s_RNG);
-		GrowNeurite(neuron.dendrites[i].points, neuron.dendrites[i].maxLength, speed, 2.0f * speed);
+		neuron.longestDist = maxLength[neuron.furthest];
+		neuron.longest     = neuron.furthest;
+	}
+	++neuron.step;
+
+	uint32_t block = static_cast<uint32_t>(neuron.furthest / c_NeuronLaneAlignment);
+	if (saturated && neuron.Length()[neuron.furthest] < maxLength[neuron.furthest])
+	{
+		auto it = std::lower_bound(neuron.activeBlocks.begin(), neuron.activeBlocks.end(), block);
+		if (it == neuron.activeBlocks.end() || *it != block)
+			neuron.activeBlocks.insert(it, block);
+	}
+}
 
-		float dist = length(neuron.dendrites[i].points[31]);
-		if (dist > neuron.furthestDist)
+// Merges the partials of the grown blocks with the kept tips of the blocks that did not grow, drops
+// the saturated blocks and advances the neuron a step.
+static size_t FinishStep(NeuronSoA& neuron, const TipPartial* partials, size_t count)
+{
+	TipPartial   total;
+	const float* tipDist = neuron.TipDist();
+	for (size_t p = 0; p < count; ++p)
+	{
+		total.grown += partials[p].grown;
+		if (partials[p].furthestDist >= 0.0f)
+			total.Merge(partials[p].furthest, partials[p].furthestDist);
+	}
+
+	size_t k = 0;
+	for (size_t block = 0; block < neuron.blockFurthest.size(); ++block)
+	{
+		if (k < neuron.activeBlocks.size() && (neuron.activeBlocks[k] & ~c_BlockSaturated) == block)
 		{
-			neuron.furthestDist = dist;
-			neuron.furthest     = i;
+			++k;
+			continue;
 		}
+		total.Merge(neuron.blockFurthest[block], tipDist[neuron.blockFurthest[block]]);
 	}
+	neuron.furthest     = total.furthest;
+	neuron.furthestDist = total.furthestDist;
 
-	neuron.dendrites[neuron.furthest].maxLength += s_GrowthDist(s_RNG);
-	neuron.dendrites[neuron.furthest].maxLength  = std::min<float>(neuron.dendrites[neuron.furthest].maxLength, 10.0f);
-	if (neuron.dendrites[neuron.furthest].maxLength > neuron.longestDist)
+	std::erase_if(neuron.activeBlocks, [](uint32_t block) { return (block & c_BlockSaturated) != 0; });
+	ExtendFurthest(neuron);
+	return total.grown * (neuron.Points() - 1);
+}
+
+size_t GrowNeuron(NeuronSoA& neuron)
+{
+	TipPartial partial;
+	GrowBlocks(neuron, 0, neuron.activeBlocks.size(), partial);
+	return FinishStep(neuron, &partial, 1);
+}
+
+size_t GrowNeuron(NeuronSoA& neuron, ThreadPool& pool)
+{
+	std::vector<TipPartial> partials(pool.ThreadCount());
+	pool.ParallelFor(neuron.activeBlocks.size(), 2, [&](size_t begin, size_t end, size_t thread) {
+		GrowBlocks(neuron, begin, end, partials[thread]);
+	});
+	return FinishStep(neuron, partials.data(), partials.size());
+}
+
+static Point PopulationPosition(size_t i, size_t count, float spacing)
+{
+	size_t side   = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+	float  offset = 0.5f * (side - 1) * spacing;
+	return { (i % side) * spacing - offset, (i / side) * spacing - offset };
+}
+
+static void AllocatePopulation(NeuronPopulation& population, size_t count, NeuronShape shape)
+{
+	population.neurons.clear();
+	population.neurons.reserve(count);
+	population.active.resize(count);
+	for (size_t i = 0; i < count; ++i)
 	{
-		neuron.longestDist = neuron.dendrites[neuron.furthest].maxLength;
-		neuron.longest     = neuron.furthest;
+		population.neurons.push_back(NeuronSoA::Uninitialized(shape));
+		population.active[i] = static_cast<uint32_t>(i);
 	}
-}
\ No newline at end of file
+}
+
+void InitPopulation(NeuronPopulation& population, size_t count, float spacing, uint64_t seed, NeuronShape shape)
+{
+	AllocatePopulation(population, count, shape);
+	for (size_t i = 0; i < count; ++i)
+		InitNeuron(population.neurons[i], PopulationPosition(i, count, spacing), seed, static_cast<uint32_t>(i));
+}
+
+void InitPopulation(NeuronPopulation& population, size_t count, float spacing, uint64_t seed, ThreadPool& pool, NeuronShape shape)
+{
+	AllocatePopulation(population, count, shape);
+	pool.ParallelFor(count, 64, [&](size_t begin, size_t end, size_t) {
+		for (size_t i = begin; i < end; ++i)
+			InitNeuron(population.neurons[i], PopulationPosition(i, count, spacing), seed, static_cast<uint32_t>(i));
+	});
+}
+
+// A neuron without active blocks has every dendrite at its maxLength, including the furthest
+// one which is capped, so it never changes again and can be left out of later steps.
+static void DropQuiescent(NeuronPopulation& population)
+{
+	std::erase_if(population.active, [&](uint32_t i) { return population.neurons[i].activeBlocks.empty(); });
+}
+
+size_t GrowPopulation(NeuronPopulation& population)
+{
+	size_t segments = 0;
+	for (uint32_t i : population.active)
+		segments += GrowNeuron(population.neurons[i]);
+	DropQuiescent(population);
+	return segments;
+}
+
+size_t GrowPopulation(NeuronPopulation& population, ThreadPool& pool)
+{
+	if (population.active.size() < pool.ThreadCount())
+	{
+		size_t segments = 0;
+		for (uint32_t i : population.active)
+			segments += GrowNeuron(population.neurons[i], pool);
+		DropQuiescent(population);
+		return segments;
+	}
+
+	struct alignas(64) Partial
+	{
+		size_t segments = 0;
+	};
+
+	std::vector<Partial> partials(pool.ThreadCount());
+	pool.ParallelFor(population.active.size(), 1, [&](size_t begin, size_t end, size_t thread) {
+		for (size_t i = begin; i < end; ++i)
+			partials[thread].segments += GrowNeuron(population.neurons[population.active[i]]);
+	});
+
+	size_t segments = 0;
+	for (auto& partial : partials)
+		segments += partial.segments;
+	DropQuiescent(population);
+	return segments;
+}
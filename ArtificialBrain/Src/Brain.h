@@ -1,62 +1,148 @@
 #pragma once
 
+#include "GrowKernel.h"
+#include "Point.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
 #include <vector>
 
-struct Point
+class ThreadPool;
+
+template <size_t P>
+struct DendriteT
 {
-	float x, y;
+	Point points[P];
+	float maxLength;
+	float length; // Sum of the segment lengths, kept up to date by GrowNeurite.
 };
 
-Point operator+(Point lhs, Point rhs);
-Point operator-(Point lhs, Point rhs);
-Point operator*(Point lhs, Point rhs);
-Point operator*(float lhs, Point rhs);
-Point operator*(Point lhs, float rhs);
-Point operator/(Point lhs, Point rhs);
-Point operator/(float lhs, Point rhs);
-Point operator/(Point lhs, float rhs);
-
-inline Point& operator+=(Point& lhs, Point rhs)
-{
-	return lhs = lhs + rhs;
-}
-inline Point& operator-=(Point& lhs, Point rhs)
+template <size_t D, size_t P>
+struct NeuronT
 {
-	return lhs = lhs - rhs;
-}
-inline Point& operator*=(Point& lhs, Point rhs)
-{
-	return lhs = lhs * rhs;
-}
-inline Point& operator*=(Point& lhs, float rhs)
-{
-	return lhs = lhs * rhs;
-}
-inline Point& operator/=(Point& lhs, Point rhs)
-{
-	return lhs = lhs / rhs;
-}
-inline Point& operator/=(Point& lhs, float rhs)
-{
-	return lhs = lhs / rhs;
-}
+	static constexpr size_t Dendrites = D;
+	static constexpr size_t Points    = P;
 
-struct Dendrite
-{
-	Point points[32];
-	float maxLength;
+	Point        pos;
+	DendriteT<P> dendrites[D];
+
+	// Tip distance from the soma per dendrite, and the dendrites still below their maxLength.
+	float    tipDist[D] {};
+	uint32_t active[D] {};
+	size_t   activeCount = 0;
+
+	size_t longest      = 0;
+	size_t furthest     = 0;
+	float  longestDist  = 0.0f;
+	float  furthestDist = 0.0f;
+
+	uint64_t seed = 0;
+	uint64_t step = 0;
+	uint32_t id   = 0;
 };
 
-struct Neuron
+using Dendrite = DendriteT<32>;
+using Neuron   = NeuronT<256, 32>;
+
+// Dendrite lanes are padded to a multiple of this so every row starts on a cache line.
+constexpr size_t c_NeuronLaneAlignment = 16;
+
+struct NeuronSoA
 {
-	Point    pos;
-	Dendrite dendrites[256];
+	explicit NeuronSoA(NeuronShape shape = {});
+	NeuronSoA(const NeuronSoA& other);
+	NeuronSoA(NeuronSoA&& other) noexcept = default;
+	NeuronSoA& operator=(const NeuronSoA& other);
+	NeuronSoA& operator=(NeuronSoA&& other) noexcept = default;
+
+	// Allocates without clearing, for callers that run InitNeuron on it right away.
+	static NeuronSoA Uninitialized(NeuronShape shape);
+
+	void Clear();
+
+	NeuronShape Shape() const { return m_Shape; }
+	size_t      Dendrites() const { return m_Shape.dendrites; }
+	size_t      Points() const { return m_Shape.points; }
+	size_t      Stride() const { return m_Stride; }
+
+	float*       X(size_t point) { return m_Data.get() + point * m_Stride; }
+	float*       Y(size_t point) { return m_Data.get() + (m_Shape.points + point) * m_Stride; }
+	float*       MaxLength() { return m_Data.get() + 2 * m_Shape.points * m_Stride; }
+	const float* X(size_t point) const { return m_Data.get() + point * m_Stride; }
+	const float* Y(size_t point) const { return m_Data.get() + (m_Shape.points + point) * m_Stride; }
+	const float* MaxLength() const { return m_Data.get() + 2 * m_Shape.points * m_Stride; }
+	float*       Length() { return m_Data.get() + (2 * m_Shape.points + 1) * m_Stride; }
+	const float* Length() const { return m_Data.get() + (2 * m_Shape.points + 1) * m_Stride; }
+
+	// Per step scratch for the drawn growth and angle of every dendrite.
+	float* Growth() { return m_Data.get() + (2 * m_Shape.points + 2) * m_Stride; }
+	float* DAngle() { return m_Data.get() + (2 * m_Shape.points + 3) * m_Stride; }
+
+	// Tip distance from the soma per dendrite, refreshed only for the active blocks.
+	float*       TipDist() { return m_Data.get() + (2 * m_Shape.points + 4) * m_Stride; }
+	const float* TipDist() const { return m_Data.get() + (2 * m_Shape.points + 4) * m_Stride; }
+
+	NeuriteLanes Lanes() { return { X(0), Y(0), MaxLength(), Length(), m_Stride, m_Shape.points }; }
+
+	Point pos;
+
+	// Sorted c_NeuronLaneAlignment wide dendrite blocks that still have a dendrite below its maxLength.
+	std::vector<uint32_t> activeBlocks;
+	// Per dendrite block, the dendrite with the furthest tip. Kept for the blocks that stopped
+	// growing so a step only has to look at the tips it moved.
+	std::vector<uint32_t> blockFurthest;
 
 	size_t longest      = 0;
 	size_t furthest     = 0;
 	float  longestDist  = 0.0f;
 	float  furthestDist = 0.0f;
+
+	uint64_t seed = 0;
+	uint64_t step = 0;
+	uint32_t id   = 0;
+
+private:
+	NeuronSoA(NeuronShape shape, bool);
+
+	struct AlignedDelete
+	{
+		void operator()(float* data) const;
+	};
+
+	size_t DataSize() const { return (2 * m_Shape.points + 5) * m_Stride; }
+
+	NeuronShape                             m_Shape;
+	size_t                                  m_Stride;
+	std::unique_ptr<float[], AlignedDelete> m_Data;
+};
+
+struct NeuronPopulation
+{
+	std::vector<NeuronSoA> neurons;
+	std::vector<uint32_t>  active; // Indices of the neurons that can still change.
 };
 
-void InitNeuron(Neuron& neuron);
-void GrowNeuron(Neuron& neuron);
\ No newline at end of file
+// currentLength is the current polyline length of points and is advanced by the growth applied.
+template <size_t N>
+bool GrowNeurite(Point (&points)[N], float& currentLength, float maxLength, float growth, float dAngle);
+
+template <size_t D, size_t P>
+void InitNeuron(NeuronT<D, P>& neuron, Point pos = { 0.0f, 0.0f }, uint64_t seed = 0, uint32_t id = 0);
+template <size_t D, size_t P>
+size_t GrowNeuron(NeuronT<D, P>& neuron);
+
+void   InitNeuron(NeuronSoA& neuron, Point pos = { 0.0f, 0.0f }, uint64_t seed = 0, uint32_t id = 0);
+// Recomputes blockFurthest from TipDist, for neurons whose rows were written directly.
+void   FindBlockFurthest(NeuronSoA& neuron);
+// Fills Growth and DAngle of dendrites [begin, end) for the neuron's current step on the scalar RNG,
+// the same draws GrowNeuron makes whatever kernel is selected.
+void   DrawGrowthScalar(NeuronSoA& neuron, size_t begin, size_t end);
+size_t GrowNeuron(NeuronSoA& neuron);
+size_t GrowNeuron(NeuronSoA& neuron, ThreadPool& pool);
+
+void   InitPopulation(NeuronPopulation& population, size_t count, float spacing, uint64_t seed, NeuronShape shape = {});
+void   InitPopulation(NeuronPopulation& population, size_t count, float spacing, uint64_t seed, ThreadPool& pool, NeuronShape shape = {});
+size_t GrowPopulation(NeuronPopulation& population);
+size_t GrowPopulation(NeuronPopulation& population, ThreadPool& pool);
@@ -0,0 +1,168 @@
+#include "Cable.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+
+#include <algorithm>
+
+template <bool Active>
+static CableSoma EliminateCableLane(const CableLanes& lanes, size_t d)
+{
+	const size_t stride = lanes.stride;
+	const size_t last   = lanes.points - 1;
+
+	float segNext = 0.0f;
+	float gaNext  = 0.0f;
+	float fNext   = 0.0f;
+	float rNext   = 0.0f;
+	for (size_t i = last; i > 0; --i)
+	{
+		float dx  = lanes.x[i * stride + d] - lanes.x[(i - 1) * stride + d];
+		float dy  = lanes.y[i * stride + d] - lanes.y[(i - 1) * stride + d];
+		float seg = std::max(std::sqrt(dx * dx + dy * dy), lanes.minSegment);
+		float len = (seg + segNext) * 0.5f;
+		float ga  = lanes.axial / seg;
+
+		float v       = lanes.v[i * stride + d];
+		float a       = lanes.capacitance * len;
+		float current = lanes.input[i * stride + d];
+		if constexpr (Active)
+			current += lanes.excitability * len * (v - v * (v * v) * (1.0f / 3.0f) - lanes.w[i * stride + d]);
+
+		float diag = (a + lanes.leak * len) + (ga + gaNext * (1.0f - fNext));
+		float rhs  = (a * v + lanes.leak * lanes.rest * len) + (current + gaNext * rNext);
+		fNext      = ga / diag;
+		rNext      = rhs / diag;
+		lanes.factor[i * stride + d] = fNext;
+		lanes.rhs[i * stride + d]    = rNext;
+
+		segNext = seg;
+		gaNext  = ga;
+	}
+	return { gaNext * (1.0f - fNext), gaNext * rNext };
+}
+
+CableSoma EliminateCableScalar(const CableLanes& lanes, size_t begin, size_t end)
+{
+	CableSoma soma;
+	for (size_t d = begin; d < end; ++d)
+	{
+		CableSoma lane  = lanes.excitability != 0.0f ? EliminateCableLane<true>(lanes, d) : EliminateCableLane<false>(lanes, d);
+		soma.diag      += lane.diag;
+		soma.rhs       += lane.rhs;
+	}
+	return soma;
+}
+
+void SubstituteCableScalar(const CableLanes& lanes, float soma, size_t begin, size_t end)
+{
+	const size_t stride = lanes.stride;
+	for (size_t d = begin; d < end; ++d)
+	{
+		float prev = soma;
+		lanes.v[d] = prev;
+		for (size_t i = 1; i < lanes.points; ++i)
+		{
+			float v                 = lanes.rhs[i * stride + d] + lanes.factor[i * stride + d] * prev;
+			lanes.v[i * stride + d] = v;
+			if (lanes.excitability != 0.0f)
+			{
+				float w                 = lanes.w[i * stride + d];
+				lanes.w[i * stride + d] = w + lanes.dt * lanes.recovery * ((v + c_CableRecoveryOffset) - w * c_CableRecoveryScale);
+			}
+			prev = v;
+		}
+	}
+}
+
+static CableSoma EliminateCable(const CableLanes& lanes, size_t begin, size_t end)
+{
+	switch (GetSimdKernel())
+	{
+	case SimdKernel::Scalar: return EliminateCableScalar(lanes, begin, end);
+	case SimdKernel::SSE41: return EliminateCableSSE41(lanes, begin, end);
+	case SimdKernel::AVX2: return EliminateCableAVX2(lanes, begin, end);
+	case SimdKernel::AVX512: return EliminateCableAVX512(lanes, begin, end);
+	}
+	return {};
+}
+
+static void SubstituteCable(const CableLanes& lanes, float soma, size_t begin, size_t end)
+{
+	switch (GetSimdKernel())
+	{
+	case SimdKernel::Scalar: SubstituteCableScalar(lanes, soma, begin, end); break;
+	case SimdKernel::SSE41: SubstituteCableSSE41(lanes, soma, begin, end); break;
+	case SimdKernel::AVX2: SubstituteCableAVX2(lanes, soma, begin, end); break;
+	case SimdKernel::AVX512: SubstituteCableAVX512(lanes, soma, begin, end); break;
+	}
+}
+
+CableParams ActiveCableParams()
+{
+	CableParams params;
+	params.leak         = 0.0f;
+	params.rest         = -1.2f;
+	params.excitability = 1.0f;
+	return params;
+}
+
+CableState::CableState(const NeuronSoA& neuron, const CableParams& params)
+	: m_Points(neuron.Points()),
+	  m_Stride(neuron.Stride()),
+	  m_Data(5 * m_Points * m_Stride)
+{
+	// The recovery starts at its fixed point for the resting voltage.
+	soma  = params.rest;
+	somaW = (params.rest + c_CableRecoveryOffset) / c_CableRecoveryScale;
+	std::fill_n(V(0), m_Points * m_Stride, soma);
+	std::fill_n(W(0), m_Points * m_Stride, somaW);
+}
+
+CableLanes CableState::Lanes(const NeuronSoA& neuron, const CableParams& params)
+{
+	float* scratch = m_Data.data() + 3 * m_Points * m_Stride;
+	return {
+		neuron.X(0), neuron.Y(0), V(0), W(0), Input(0), scratch, scratch + m_Points * m_Stride,
+		m_Stride, m_Points,
+		params.capacitance / params.dt, params.leak, params.rest, params.axial, params.minSegment,
+		params.excitability, params.recovery, params.dt
+	};
+}
+
+void StepCable(CableState& cable, const NeuronSoA& neuron, const CableParams& params)
+{
+	CableLanes lanes = cable.Lanes(neuron, params);
+	CableSoma  terms = EliminateCable(lanes, 0, neuron.Dendrites());
+
+	// The soma row couples every dendrite, with the dendrites eliminated it is a single equation.
+	float len     = params.somaLength;
+	float a       = params.capacitance / params.dt * len;
+	float v       = cable.soma;
+	float current = cable.somaInput;
+	if (params.excitability != 0.0f)
+		current += params.excitability * len * (v - v * v * v / 3.0f - cable.somaW);
+	float soma = (a * v + params.leak * params.rest * len + current + terms.rhs) / (a + params.leak * len + terms.diag);
+	if (params.excitability != 0.0f)
+		cable.somaW += params.dt * params.recovery * ((soma + c_CableRecoveryOffset) - cable.somaW * c_CableRecoveryScale);
+	cable.soma = soma;
+
+	SubstituteCable(lanes, soma, 0, neuron.Dendrites());
+}
+
+void InitCables(std::vector<CableState>& cables, const NeuronPopulation& population, const CableParams& params)
+{
+	cables.clear();
+	cables.reserve(population.neurons.size());
+	for (const NeuronSoA& neuron : population.neurons)
+		cables.emplace_back(neuron, params);
+}
+
+void StepCables(std::vector<CableState>& cables, const NeuronPopulation& population, const CableParams& params, ThreadPool& pool)
+{
+	pool.ParallelFor(cables.size(), 4, [&](size_t begin, size_t end, size_t) {
+		for (size_t n = begin; n < end; ++n)
+			StepCable(cables[n], population.neurons[n], params);
+	});
+}
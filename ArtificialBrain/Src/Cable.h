@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Brain.h"
+#include "CableKernel.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+class ThreadPool;
+
+// Cable equation constants in model units, time constant capacitance / leak. Every dendrite point
+// past the soma is one compartment covering half of each adjacent segment.
+struct CableParams
+{
+	float dt           = 0.05f;
+	float capacitance  = 1.0f; // Per unit length.
+	float leak         = 1.0f; // Per unit length.
+	float rest         = 0.0f;
+	float axial        = 0.01f; // Axial conductance per unit length, the length constant is sqrt(axial / leak).
+	float somaLength   = 0.02f; // Soma membrane expressed as dendrite length.
+	float minSegment   = 1e-3f; // Segments are at least this long, keeps collapsed points finite.
+	float excitability = 0.0f;  // FitzHugh-Nagumo current per unit length, 0 for a passive membrane.
+	float recovery     = 0.08f;
+};
+
+// Parameters for an excitable membrane: no leak and FitzHugh-Nagumo dynamics resting near -1.2.
+CableParams ActiveCableParams();
+
+// Membrane state of one neuron with rows laid out like the neurite points of its NeuronSoA, so
+// V(i)[d] is the voltage at point i of dendrite d. Row 0 mirrors the soma after every step.
+struct CableState
+{
+	CableState(const NeuronSoA& neuron, const CableParams& params);
+
+	float*       V(size_t point) { return m_Data.data() + point * m_Stride; }
+	const float* V(size_t point) const { return m_Data.data() + point * m_Stride; }
+	float*       W(size_t point) { return m_Data.data() + (m_Points + point) * m_Stride; }
+	// Current injected into each compartment, held until changed.
+	float*       Input(size_t point) { return m_Data.data() + (2 * m_Points + point) * m_Stride; }
+	const float* Input(size_t point) const { return m_Data.data() + (2 * m_Points + point) * m_Stride; }
+
+	CableLanes Lanes(const NeuronSoA& neuron, const CableParams& params);
+
+	float soma      = 0.0f;
+	float somaW     = 0.0f;
+	float somaInput = 0.0f;
+
+private:
+	size_t             m_Points;
+	size_t             m_Stride;
+	std::vector<float> m_Data; // V, W, Input and the two scratch blocks of m_Points rows each.
+};
+
+// Advances the membrane of neuron by one params.dt step on the kernel chosen by SetSimdKernel.
+void StepCable(CableState& cable, const NeuronSoA& neuron, const CableParams& params);
+
+void InitCables(std::vector<CableState>& cables, const NeuronPopulation& population, const CableParams& params);
+// Steps every neuron of the population, the cables must come from InitCables on it.
+void StepCables(std::vector<CableState>& cables, const NeuronPopulation& population, const CableParams& params, ThreadPool& pool);
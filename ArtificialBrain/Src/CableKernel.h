@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+
+// FitzHugh-Nagumo recovery, w' = recovery * (v + offset - scale * w).
+constexpr float c_CableRecoveryOffset = 0.7f;
+constexpr float c_CableRecoveryScale  = 0.8f;
+
+// Membrane voltage along the neurite points, rows laid out like NeuriteLanes so v[i * stride + d]
+// is the compartment at point i of dendrite d. Row 0 receives the soma voltage, rows 1 and up are
+// solved. factor and rhs are scratch rows holding the eliminated system between the two passes.
+struct CableLanes
+{
+	const float* x;
+	const float* y;
+	float*       v;
+	float*       w;     // Recovery, only used when excitability is not 0.
+	const float* input; // Injected current per compartment.
+	float*       factor;
+	float*       rhs;
+	size_t       stride;
+	size_t       points;
+	float        capacitance; // Per unit length, divided by dt.
+	float        leak;        // Per unit length.
+	float        rest;
+	float        axial; // Divided by the segment length gives the conductance between two points.
+	float        minSegment;
+	float        excitability; // Per unit length, 0 for a passive membrane.
+	float        recovery;
+	float        dt;
+};
+
+// Soma row terms left by the eliminated dendrites.
+struct CableSoma
+{
+	float diag = 0.0f;
+	float rhs  = 0.0f;
+};
+
+// Backward Euler cable step split around the soma: Eliminate reduces dendrites [begin, end) from
+// the tip down and returns their soma terms, Substitute then solves the compartments outwards
+// from the soma voltage.
+CableSoma EliminateCableScalar(const CableLanes& lanes, size_t begin, size_t end);
+CableSoma EliminateCableSSE41(const CableLanes& lanes, size_t begin, size_t end);
+CableSoma EliminateCableAVX2(const CableLanes& lanes, size_t begin, size_t end);
+CableSoma EliminateCableAVX512(const CableLanes& lanes, size_t begin, size_t end);
+
+void SubstituteCableScalar(const CableLanes& lanes, float soma, size_t begin, size_t end);
+void SubstituteCableSSE41(const CableLanes& lanes, float soma, size_t begin, size_t end);
+void SubstituteCableAVX2(const CableLanes& lanes, float soma, size_t begin, size_t end);
+void SubstituteCableAVX512(const CableLanes& lanes, float soma, size_t begin, size_t end);
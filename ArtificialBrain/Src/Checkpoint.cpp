@@ -0,0 +1,364 @@
+#include "Checkpoint.h"
+
+#include <cstdio>
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+struct FileClose
+{
+	void operator()(FILE* file) const { std::fclose(file); }
+};
+
+using File = std::unique_ptr<FILE, FileClose>;
+
+// Sticky failure flag so a sequence of reads or writes is checked once at the end.
+class CheckpointStream
+{
+public:
+	explicit CheckpointStream(FILE* file)
+		: m_File(file)
+	{
+	}
+
+	bool Ok() const { return m_Ok; }
+
+	template <class T>
+	void Write(const T* data, size_t count)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		m_Ok = m_Ok && std::fwrite(data, sizeof(T), count, m_File) == count;
+	}
+	template <class T>
+	void Read(T* data, size_t count)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		m_Ok = m_Ok && std::fread(data, sizeof(T), count, m_File) == count;
+	}
+
+	template <class T>
+	void Write(const T& value) { Write(&value, 1); }
+	template <class T>
+	void Read(T& value) { Read(&value, 1); }
+
+	// Bytes left after the read position, zero if the file cannot seek.
+	uint64_t Remaining() const
+	{
+#ifdef _WIN32
+		const int64_t at = _ftelli64(m_File);
+		if (at < 0 || _fseeki64(m_File, 0, SEEK_END) != 0)
+			return 0;
+		const int64_t end = _ftelli64(m_File);
+		if (_fseeki64(m_File, at, SEEK_SET) != 0)
+			return 0;
+#else
+		const off_t at = ftello(m_File);
+		if (at < 0 || fseeko(m_File, 0, SEEK_END) != 0)
+			return 0;
+		const off_t end = ftello(m_File);
+		if (fseeko(m_File, at, SEEK_SET) != 0)
+			return 0;
+#endif
+		return end > at ? static_cast<uint64_t>(end - at) : 0;
+	}
+
+private:
+	FILE* m_File;
+	bool  m_Ok = true;
+};
+
+static bool ReadHeader(CheckpointStream& stream, CheckpointHeader& header, CheckpointKind kind)
+{
+	stream.Read(header);
+	return stream.Ok() && header.magic == c_CheckpointMagic && header.version == c_CheckpointVersion && header.kind == kind;
+}
+
+// Shared tail of both neuron layouts.
+template <class NeuronT>
+static void WriteNeuronState(CheckpointStream& stream, const NeuronT& neuron)
+{
+	uint64_t longest  = neuron.longest;
+	uint64_t furthest = neuron.furthest;
+	stream.Write(longest);
+	stream.Write(furthest);
+	stream.Write(neuron.longestDist);
+	stream.Write(neuron.furthestDist);
+	stream.Write(neuron.seed);
+	stream.Write(neuron.step);
+	stream.Write(neuron.id);
+}
+
+template <class NeuronT>
+static void ReadNeuronState(CheckpointStream& stream, NeuronT& neuron)
+{
+	uint64_t longest  = 0;
+	uint64_t furthest = 0;
+	stream.Read(longest);
+	stream.Read(furthest);
+	stream.Read(neuron.longestDist);
+	stream.Read(neuron.furthestDist);
+	stream.Read(neuron.seed);
+	stream.Read(neuron.step);
+	stream.Read(neuron.id);
+	neuron.longest  = static_cast<size_t>(longest);
+	neuron.furthest = static_cast<size_t>(furthest);
+}
+
+// Smallest stored size of one neuron with the header's shape, the same for both layouts. Zero if
+// even one would not fit in the bytes left.
+static uint64_t NeuronBytes(const CheckpointHeader& header, uint64_t remaining)
+{
+	constexpr uint64_t c_StateBytes = 2 * sizeof(uint64_t) + 2 * sizeof(float) + sizeof(NeuronSoA::seed) + sizeof(NeuronSoA::step) + sizeof(NeuronSoA::id);
+	constexpr uint64_t c_FixedBytes = sizeof(NeuronSoA::pos) + sizeof(uint64_t) + c_StateBytes;
+	if (header.dendrites == 0 || header.points < 2 || remaining < c_FixedBytes)
+		return 0;
+	const uint64_t rowBudget = (remaining - c_FixedBytes) / sizeof(float);
+	if (header.dendrites > rowBudget || header.points > rowBudget)
+		return 0;
+	const uint64_t rows = 2 * header.points + 3; // X, Y, max length, length and tip distance.
+	if (rows > rowBudget / header.dendrites)
+		return 0;
+	return rows * header.dendrites * sizeof(float) + c_FixedBytes;
+}
+
+// Whether the neurons the header describes fit in the bytes after it. Checked before anything is
+// sized from the header so a corrupt one fails the load instead of the allocation.
+static bool FitsInFile(const CheckpointHeader& header, uint64_t remaining)
+{
+	if (header.kind == CheckpointKind::Population)
+	{
+		if (remaining < sizeof(uint64_t))
+			return false;
+		remaining -= sizeof(uint64_t);
+		if (header.count == 0)
+			return header.dendrites != 0 && header.points >= 2;
+	}
+	const uint64_t neuronBytes = NeuronBytes(header, remaining);
+	return neuronBytes != 0 && header.count <= remaining / neuronBytes;
+}
+
+// Only the rows that survive a step are stored, Growth and DAngle are per step scratch and the
+// lane padding is left out.
+static void WriteNeuronSoA(CheckpointStream& stream, const NeuronSoA& neuron)
+{
+	const size_t dendrites = neuron.Dendrites();
+	stream.Write(neuron.pos);
+	for (size_t j = 0; j < neuron.Points(); ++j)
+		stream.Write(neuron.X(j), dendrites);
+	for (size_t j = 0; j < neuron.Points(); ++j)
+		stream.Write(neuron.Y(j), dendrites);
+	stream.Write(neuron.MaxLength(), dendrites);
+	stream.Write(neuron.Length(), dendrites);
+	stream.Write(neuron.TipDist(), dendrites);
+
+	uint64_t blocks = neuron.activeBlocks.size();
+	stream.Write(blocks);
+	stream.Write(neuron.activeBlocks.data(), neuron.activeBlocks.size());
+	WriteNeuronState(stream, neuron);
+}
+
+// Index lists are written sorted without repeats, anything else is a corrupt file.
+static bool IsIncreasing(const std::vector<uint32_t>& indices, uint64_t end)
+{
+	for (size_t i = 0; i < indices.size(); ++i)
+		if (indices[i] >= end || (i > 0 && indices[i] <= indices[i - 1]))
+			return false;
+	return true;
+}
+
+static bool ReadNeuronSoA(CheckpointStream& stream, NeuronSoA& neuron)
+{
+	const size_t dendrites = neuron.Dendrites();
+	const size_t maxBlocks = (dendrites + c_NeuronLaneAlignment - 1) / c_NeuronLaneAlignment;
+	stream.Read(neuron.pos);
+	for (size_t j = 0; j < neuron.Points(); ++j)
+		stream.Read(neuron.X(j), dendrites);
+	for (size_t j = 0; j < neuron.Points(); ++j)
+		stream.Read(neuron.Y(j), dendrites);
+	stream.Read(neuron.MaxLength(), dendrites);
+	stream.Read(neuron.Length(), dendrites);
+	stream.Read(neuron.TipDist(), dendrites);
+
+	uint64_t blocks = 0;
+	stream.Read(blocks);
+	if (!stream.Ok() || blocks > maxBlocks)
+		return false;
+	neuron.activeBlocks.resize(static_cast<size_t>(blocks));
+	stream.Read(neuron.activeBlocks.data(), neuron.activeBlocks.size());
+	ReadNeuronState(stream, neuron);
+	FindBlockFurthest(neuron);
+	return stream.Ok() && neuron.longest < dendrites && neuron.furthest < dendrites && IsIncreasing(neuron.activeBlocks, maxBlocks);
+}
+
+bool ReadCheckpointHeader(const char* path, CheckpointHeader& header)
+{
+	File file(std::fopen(path, "rb"));
+	if (!file)
+		return false;
+	CheckpointStream stream(file.get());
+	stream.Read(header);
+	return stream.Ok() && header.magic == c_CheckpointMagic && FitsInFile(header, stream.Remaining());
+}
+
+template <size_t D, size_t P>
+bool SaveNeuron(const char* path, const NeuronT<D, P>& neuron)
+{
+	File file(std::fopen(path, "wb"));
+	if (!file)
+		return false;
+
+	CheckpointHeader header;
+	header.kind      = CheckpointKind::Neuron;
+	header.dendrites = D;
+	header.points    = P;
+	header.count     = 1;
+
+	CheckpointStream stream(file.get());
+	stream.Write(header);
+	stream.Write(neuron.pos);
+	for (auto& dendrite : neuron.dendrites)
+	{
+		stream.Write(dendrite.points, P);
+		stream.Write(dendrite.maxLength);
+		stream.Write(dendrite.length);
+	}
+	stream.Write(neuron.tipDist, D);
+
+	uint64_t activeCount = neuron.activeCount;
+	stream.Write(activeCount);
+	stream.Write(neuron.active, neuron.activeCount);
+	WriteNeuronState(stream, neuron);
+	return stream.Ok() && std::fclose(file.release()) == 0;
+}
+
+template <size_t D, size_t P>
+bool LoadNeuron(const char* path, NeuronT<D, P>& neuron)
+{
+	File file(std::fopen(path, "rb"));
+	if (!file)
+		return false;
+
+	CheckpointStream           stream(file.get());
+	CheckpointHeader header;
+	if (!ReadHeader(stream, header, CheckpointKind::Neuron) || header.dendrites != D || header.points != P || header.count != 1)
+		return false;
+
+	stream.Read(neuron.pos);
+	for (auto& dendrite : neuron.dendrites)
+	{
+		stream.Read(dendrite.points, P);
+		stream.Read(dendrite.maxLength);
+		stream.Read(dendrite.length);
+	}
+	stream.Read(neuron.tipDist, D);
+
+	uint64_t activeCount = 0;
+	stream.Read(activeCount);
+	if (!stream.Ok() || activeCount > D)
+		return false;
+	neuron.activeCount = static_cast<size_t>(activeCount);
+	stream.Read(neuron.active, neuron.activeCount);
+	ReadNeuronState(stream, neuron);
+	return stream.Ok() && neuron.longest < D && neuron.furthest < D && std::all_of(neuron.active, neuron.active + neuron.activeCount, [](uint32_t i) { return i < D; });
+}
+
+template bool SaveNeuron<64, 8>(const char* path, const NeuronT<64, 8>& neuron);
+template bool SaveNeuron<256, 32>(const char* path, const NeuronT<256, 32>& neuron);
+template bool SaveNeuron<1024, 64>(const char* path, const NeuronT<1024, 64>& neuron);
+template bool LoadNeuron<64, 8>(const char* path, NeuronT<64, 8>& neuron);
+template bool LoadNeuron<256, 32>(const char* path, NeuronT<256, 32>& neuron);
+template bool LoadNeuron<1024, 64>(const char* path, NeuronT<1024, 64>& neuron);
+
+bool SaveNeuron(const char* path, const NeuronSoA& neuron)
+{
+	File file(std::fopen(path, "wb"));
+	if (!file)
+		return false;
+
+	CheckpointHeader header;
+	header.kind      = CheckpointKind::Neuron;
+	header.dendrites = neuron.Dendrites();
+	header.points    = neuron.Points();
+	header.count     = 1;
+
+	CheckpointStream stream(file.get());
+	stream.Write(header);
+	WriteNeuronSoA(stream, neuron);
+	return stream.Ok() && std::fclose(file.release()) == 0;
+}
+
+bool LoadNeuron(const char* path, NeuronSoA& neuron)
+{
+	File file(std::fopen(path, "rb"));
+	if (!file)
+		return false;
+
+	CheckpointStream           stream(file.get());
+	CheckpointHeader header;
+	if (!ReadHeader(stream, header, CheckpointKind::Neuron) || header.count != 1 || !FitsInFile(header, stream.Remaining()))
+		return false;
+
+	NeuronSoA loaded({ static_cast<size_t>(header.dendrites), static_cast<size_t>(header.points) });
+	if (!ReadNeuronSoA(stream, loaded))
+		return false;
+	neuron = std::move(loaded);
+	return true;
+}
+
+bool SavePopulation(const char* path, const NeuronPopulation& population)
+{
+	File file(std::fopen(path, "wb"));
+	if (!file)
+		return false;
+
+	NeuronShape      shape = population.neurons.empty() ? NeuronShape {} : population.neurons[0].Shape();
+	CheckpointHeader header;
+	header.kind      = CheckpointKind::Population;
+	header.dendrites = shape.dendrites;
+	header.points    = shape.points;
+	header.count     = population.neurons.size();
+
+	CheckpointStream stream(file.get());
+	stream.Write(header);
+
+	uint64_t activeCount = population.active.size();
+	stream.Write(activeCount);
+	stream.Write(population.active.data(), population.active.size());
+	for (auto& neuron : population.neurons)
+		WriteNeuronSoA(stream, neuron);
+	return stream.Ok() && std::fclose(file.release()) == 0;
+}
+
+bool LoadPopulation(const char* path, NeuronPopulation& population)
+{
+	File file(std::fopen(path, "rb"));
+	if (!file)
+		return false;
+
+	CheckpointStream           stream(file.get());
+	CheckpointHeader header;
+	if (!ReadHeader(stream, header, CheckpointKind::Population) || !FitsInFile(header, stream.Remaining()))
+		return false;
+
+	NeuronPopulation loaded;
+	uint64_t         activeCount = 0;
+	stream.Read(activeCount);
+	if (!stream.Ok() || activeCount > header.count)
+		return false;
+	loaded.active.resize(static_cast<size_t>(activeCount));
+	stream.Read(loaded.active.data(), loaded.active.size());
+	if (!stream.Ok() || !IsIncreasing(loaded.active, header.count))
+		return false;
+
+	NeuronShape shape = { static_cast<size_t>(header.dendrites), static_cast<size_t>(header.points) };
+	loaded.neurons.reserve(static_cast<size_t>(header.count));
+	for (uint64_t i = 0; i < header.count; ++i)
+	{
+		loaded.neurons.emplace_back(shape);
+		if (!ReadNeuronSoA(stream, loaded.neurons.back()))
+			return false;
+	}
+	population = std::move(loaded);
+	return true;
+}
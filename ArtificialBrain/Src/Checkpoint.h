@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Brain.h"
+
+#include <cstdint>
+
+// Versioned binary snapshots of grown neurons. The counter based RNG has no state beyond each
+// neuron's seed, id and step, so a restored neuron continues exactly where the saved one stopped.
+// Files are written in host byte order, loading rejects a different magic, version or kind.
+constexpr uint32_t c_CheckpointMagic   = 0x4B434241; // "ABCK"
+constexpr uint32_t c_CheckpointVersion = 1;
+
+enum class CheckpointKind : uint32_t
+{
+	Neuron,
+	Population
+};
+
+// Fixed size header at the start of every checkpoint file.
+struct CheckpointHeader
+{
+	uint32_t       magic     = c_CheckpointMagic;
+	uint32_t       version   = c_CheckpointVersion;
+	CheckpointKind kind      = CheckpointKind::Neuron;
+	uint32_t       reserved  = 0;
+	uint64_t       dendrites = 0;
+	uint64_t       points    = 0;
+	uint64_t       count     = 0; // Neurons in the file.
+};
+
+// Reads only the header, for inspecting a file's shape before loading it. Fails if the neurons the
+// header describes cannot fit in the file.
+bool ReadCheckpointHeader(const char* path, CheckpointHeader& header);
+
+// The AoS neuron's shape is fixed at compile time, loading fails if the file's shape differs.
+template <size_t D, size_t P>
+bool SaveNeuron(const char* path, const NeuronT<D, P>& neuron);
+template <size_t D, size_t P>
+bool LoadNeuron(const char* path, NeuronT<D, P>& neuron);
+
+bool SaveNeuron(const char* path, const NeuronSoA& neuron);
+bool LoadNeuron(const char* path, NeuronSoA& neuron);
+
+// Every neuron in a population shares the shape stored in the header.
+bool SavePopulation(const char* path, const NeuronPopulation& population);
+bool LoadPopulation(const char* path, NeuronPopulation& population);
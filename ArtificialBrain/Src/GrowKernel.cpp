@@ -0,0 +1,120 @@
+#include "GrowKernel.h"
+#include "Brain.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+static GrowNeuritesFn KernelFn(SimdKernel kernel)
+{
+	switch (kernel)
+	{
+	case SimdKernel::Scalar: return &GrowNeuritesScalar;
+	case SimdKernel::SSE41: return &GrowNeuritesSSE41;
+	case SimdKernel::AVX2: return &GrowNeuritesAVX2;
+	case SimdKernel::AVX512: return &GrowNeuritesAVX512;
+	}
+	return &GrowNeuritesScalar;
+}
+
+const char* GrowthModeName(GrowthMode mode)
+{
+	switch (mode)
+	{
+	case GrowthMode::Trig: return "trig";
+	case GrowthMode::Vector: return "vector";
+	}
+	return "unknown";
+}
+
+bool ParseGrowthMode(const char* name, GrowthMode& mode)
+{
+	for (GrowthMode candidate : { GrowthMode::Trig, GrowthMode::Vector })
+	{
+		if (std::strcmp(name, GrowthModeName(candidate)) == 0)
+		{
+			mode = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+static SimdKernel     s_GrowKernel   = BestSimdKernel();
+static GrowNeuritesFn s_GrowNeurites = KernelFn(s_GrowKernel);
+static GrowthMode     s_GrowthMode   = GrowthMode::Vector;
+
+void SetGrowKernel(SimdKernel kernel)
+{
+	if (!IsSimdKernelSupported(kernel))
+		kernel = SimdKernel::Scalar;
+	s_GrowKernel   = kernel;
+	s_GrowNeurites = KernelFn(kernel);
+}
+
+SimdKernel GetGrowKernel()
+{
+	return s_GrowKernel;
+}
+
+void SetGrowthMode(GrowthMode mode)
+{
+	s_GrowthMode = mode;
+}
+
+GrowthMode GetGrowthMode()
+{
+	return s_GrowthMode;
+}
+
+size_t GrowNeurites(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end)
+{
+	return s_GrowNeurites(lanes, growth, dAngle, begin, end, s_GrowthMode);
+}
+
+float VerifyGrowKernel(SimdKernel kernel, GrowthMode mode, NeuronShape shape)
+{
+	if (!IsSimdKernelSupported(kernel))
+		return INFINITY;
+
+	auto reference = std::make_unique<NeuronSoA>(shape);
+	auto candidate = std::make_unique<NeuronSoA>(shape);
+	// Grown on the scalar trig path directly so the selected kernel and mode are never touched.
+	InitNeuron(*reference);
+	for (; reference->step < 64; ++reference->step)
+	{
+		DrawGrowthScalar(*reference, 0, shape.dendrites);
+		GrowNeuritesScalar(reference->Lanes(), reference->Growth(), reference->DAngle(), 0, shape.dendrites, GrowthMode::Trig);
+	}
+	*candidate = *reference;
+
+	std::mt19937                          rng(1234);
+	std::uniform_real_distribution<float> growthDist(0.0001f, 0.01f);
+	std::uniform_real_distribution<float> thetaDist(-3.14159265f, 3.14159265f);
+
+	std::vector<float> growth(shape.dendrites);
+	std::vector<float> dAngle(shape.dendrites);
+	for (size_t d = 0; d < shape.dendrites; ++d)
+	{
+		growth[d] = growthDist(rng);
+		dAngle[d] = thetaDist(rng) * 2.0f * growth[d];
+	}
+
+	GrowNeuritesScalar(reference->Lanes(), growth.data(), dAngle.data(), 0, shape.dendrites, GrowthMode::Trig);
+	KernelFn(kernel)(candidate->Lanes(), growth.data(), dAngle.data(), 0, shape.dendrites, mode);
+
+	float maxError = 0.0f;
+	for (size_t i = 0; i < shape.points; ++i)
+	{
+		for (size_t d = 0; d < shape.dendrites; ++d)
+		{
+			maxError = std::max<float>(maxError, std::fabs(reference->X(i)[d] - candidate->X(i)[d]));
+			maxError = std::max<float>(maxError, std::fabs(reference->Y(i)[d] - candidate->Y(i)[d]));
+		}
+	}
+	return maxError;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Simd.h"
+
+#include <cstddef>
+#include <cstdint>
+
+enum class GrowthMode
+{
+	Trig,
+	Vector
+};
+
+constexpr float c_GrowKernelTolerance = 1e-4f;
+
+struct NeuronShape
+{
+	size_t dendrites = 256;
+	size_t points    = 32;
+};
+
+// Neurite points stored point major, the x of point i of dendrite d lives at x[i * stride + d].
+// length holds the current polyline length of every dendrite and is advanced by the kernels.
+struct NeuriteLanes
+{
+	float*       x;
+	float*       y;
+	const float* maxLength;
+	float*       length;
+	size_t       stride;
+	size_t       points;
+};
+
+using GrowNeuritesFn = size_t (*)(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode);
+
+size_t GrowNeuritesScalar(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode);
+size_t GrowNeuritesSSE41(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode);
+size_t GrowNeuritesAVX2(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode);
+size_t GrowNeuritesAVX512(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode);
+
+void RandomUniformBatchScalar(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1);
+void RandomUniformBatchSSE41(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1);
+void RandomUniformBatchAVX2(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1);
+void RandomUniformBatchAVX512(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1);
+
+const char* GrowthModeName(GrowthMode mode);
+bool        ParseGrowthMode(const char* name, GrowthMode& mode);
+
+void       SetGrowKernel(SimdKernel kernel);
+SimdKernel GetGrowKernel();
+void       SetGrowthMode(GrowthMode mode);
+GrowthMode GetGrowthMode();
+size_t     GrowNeurites(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end);
+
+float VerifyGrowKernel(SimdKernel kernel, GrowthMode mode, NeuronShape shape = {});
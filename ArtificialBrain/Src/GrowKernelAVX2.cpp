@@ -0,0 +1,91 @@
+#include "GrowKernelSIMD.h"
+
+#include <immintrin.h>
+
+struct AVX2Ops
+{
+	using F = __m256;
+	using M = __m256;
+
+	static constexpr size_t Width = 8;
+
+	static F Load(const float* p) { return _mm256_loadu_ps(p); }
+	static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+	static F Set(float v) { return _mm256_set1_ps(v); }
+
+	static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+	static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+	static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+	static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+	static F Min(F a, F b) { return _mm256_min_ps(a, b); }
+	static F Max(F a, F b) { return _mm256_max_ps(a, b); }
+	static F Sqrt(F a) { return _mm256_sqrt_ps(a); }
+	static F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	static F Round(F a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	static F Floor(F a) { return _mm256_floor_ps(a); }
+
+	static M CmpEQ(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+	static M CmpNE(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+	static M CmpLT(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static M CmpGT(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static M Or(M a, M b) { return _mm256_or_ps(a, b); }
+	static F Select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+
+	static F Gather(const float* base, const uint32_t* index) { return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index)), 4); }
+	static float Sum(F a)
+	{
+		__m128 h = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+		h        = _mm_hadd_ps(h, h);
+		return _mm_cvtss_f32(_mm_hadd_ps(h, h));
+	}
+
+	using U = __m256i;
+
+	static U SetU(uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+	static U IotaU(uint32_t base) { return _mm256_add_epi32(SetU(base), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+	static U AddU(U a, U b) { return _mm256_add_epi32(a, b); }
+	static U XorU(U a, U b) { return _mm256_xor_si256(a, b); }
+	static F ToUniform(U a) { return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(a, 8)), _mm256_set1_ps(1.0f / 16777216.0f)); }
+
+	static void MulHiLo(U a, uint32_t b, U& hi, U& lo)
+	{
+		U m    = SetU(b);
+		U even = _mm256_mul_epu32(a, m);
+		U odd  = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+		hi     = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+		lo     = _mm256_mullo_epi32(a, m);
+	}
+
+	static size_t Count(M m)
+	{
+		size_t count = 0;
+		for (int bits = _mm256_movemask_ps(m); bits; bits &= bits - 1)
+			++count;
+		return count;
+	}
+};
+
+size_t GrowNeuritesAVX2(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode)
+{
+	return GrowNeuritesDispatch<AVX2Ops>(lanes, growth, dAngle, begin, end, mode);
+}
+
+void RandomUniformBatchAVX2(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1)
+{
+	RandomUniformSIMD<AVX2Ops>(seed, neuron, step, begin, end, u0, u1);
+}
+
+void PropagateRowsAVX2(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end)
+{
+	PropagateRowsSIMD<AVX2Ops>(rows, input, output, begin, end);
+}
+
+CableSoma EliminateCableAVX2(const CableLanes& lanes, size_t begin, size_t end)
+{
+	return EliminateCableDispatch<AVX2Ops>(lanes, begin, end);
+}
+
+void SubstituteCableAVX2(const CableLanes& lanes, float soma, size_t begin, size_t end)
+{
+	SubstituteCableDispatch<AVX2Ops>(lanes, soma, begin, end);
+}
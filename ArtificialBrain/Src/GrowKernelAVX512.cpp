@@ -0,0 +1,86 @@
+#include "GrowKernelSIMD.h"
+
+#include <immintrin.h>
+
+struct AVX512Ops
+{
+	using F = __m512;
+	using M = __mmask16;
+
+	static constexpr size_t Width = 16;
+
+	static F Load(const float* p) { return _mm512_loadu_ps(p); }
+	static void Store(float* p, F v) { _mm512_storeu_ps(p, v); }
+	static F Set(float v) { return _mm512_set1_ps(v); }
+
+	static F Add(F a, F b) { return _mm512_add_ps(a, b); }
+	static F Sub(F a, F b) { return _mm512_sub_ps(a, b); }
+	static F Mul(F a, F b) { return _mm512_mul_ps(a, b); }
+	static F Div(F a, F b) { return _mm512_div_ps(a, b); }
+	static F Min(F a, F b) { return _mm512_min_ps(a, b); }
+	static F Max(F a, F b) { return _mm512_max_ps(a, b); }
+	static F Sqrt(F a) { return _mm512_sqrt_ps(a); }
+	static F Abs(F a) { return _mm512_abs_ps(a); }
+	static F Round(F a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	static F Floor(F a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+	static M CmpEQ(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+	static M CmpNE(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+	static M CmpLT(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+	static M CmpGT(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+	static M Or(M a, M b) { return static_cast<M>(a | b); }
+	static F Select(M m, F a, F b) { return _mm512_mask_blend_ps(m, b, a); }
+
+	static F Gather(const float* base, const uint32_t* index) { return _mm512_i32gather_ps(_mm512_loadu_si512(index), base, 4); }
+	static float Sum(F a) { return _mm512_reduce_add_ps(a); }
+
+	using U = __m512i;
+
+	static U SetU(uint32_t v) { return _mm512_set1_epi32(static_cast<int>(v)); }
+	static U IotaU(uint32_t base) { return _mm512_add_epi32(SetU(base), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)); }
+	static U AddU(U a, U b) { return _mm512_add_epi32(a, b); }
+	static U XorU(U a, U b) { return _mm512_xor_si512(a, b); }
+	static F ToUniform(U a) { return _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_srli_epi32(a, 8)), _mm512_set1_ps(1.0f / 16777216.0f)); }
+
+	static void MulHiLo(U a, uint32_t b, U& hi, U& lo)
+	{
+		U m    = SetU(b);
+		U even = _mm512_mul_epu32(a, m);
+		U odd  = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), m);
+		hi     = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+		lo     = _mm512_mullo_epi32(a, m);
+	}
+
+	static size_t Count(M m)
+	{
+		size_t count = 0;
+		for (unsigned bits = m; bits; bits &= bits - 1)
+			++count;
+		return count;
+	}
+};
+
+size_t GrowNeuritesAVX512(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode)
+{
+	return GrowNeuritesDispatch<AVX512Ops>(lanes, growth, dAngle, begin, end, mode);
+}
+
+void RandomUniformBatchAVX512(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1)
+{
+	RandomUniformSIMD<AVX512Ops>(seed, neuron, step, begin, end, u0, u1);
+}
+
+void PropagateRowsAVX512(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end)
+{
+	PropagateRowsSIMD<AVX512Ops>(rows, input, output, begin, end);
+}
+
+CableSoma EliminateCableAVX512(const CableLanes& lanes, size_t begin, size_t end)
+{
+	return EliminateCableDispatch<AVX512Ops>(lanes, begin, end);
+}
+
+void SubstituteCableAVX512(const CableLanes& lanes, float soma, size_t begin, size_t end)
+{
+	SubstituteCableDispatch<AVX512Ops>(lanes, soma, begin, end);
+}
@@ -0,0 +1,370 @@
+#pragma once
+
+#include "CableKernel.h"
+#include "GrowKernel.h"
+#include "SynapseKernel.h"
+
+#include <cstdint>
+
+// Included only by the per ISA translation units, everything in here is templated on
+// the Ops traits so no inline function is shared between units built with different flags.
+
+template <class Ops>
+inline typename Ops::F Atan2(typename Ops::F y, typename Ops::F x)
+{
+	using F = typename Ops::F;
+	using M = typename Ops::M;
+
+	F ax = Ops::Abs(x);
+	F ay = Ops::Abs(y);
+	F mx = Ops::Max(ax, ay);
+	F mn = Ops::Min(ax, ay);
+	M zr = Ops::CmpEQ(mx, Ops::Set(0.0f));
+	F a  = Ops::Div(mn, Ops::Select(zr, Ops::Set(1.0f), mx));
+
+	M big  = Ops::CmpGT(a, Ops::Set(0.41421356f));
+	F base = Ops::Select(big, Ops::Set(0.78539816f), Ops::Set(0.0f));
+	a      = Ops::Select(big, Ops::Div(Ops::Sub(a, Ops::Set(1.0f)), Ops::Add(a, Ops::Set(1.0f))), a);
+
+	F z = Ops::Mul(a, a);
+	F p = Ops::Set(8.05374449538e-2f);
+	p   = Ops::Sub(Ops::Mul(p, z), Ops::Set(1.38776856032e-1f));
+	p   = Ops::Add(Ops::Mul(p, z), Ops::Set(1.99777106478e-1f));
+	p   = Ops::Sub(Ops::Mul(p, z), Ops::Set(3.33329491539e-1f));
+	F r = Ops::Add(base, Ops::Add(Ops::Mul(Ops::Mul(p, z), a), a));
+
+	r = Ops::Select(Ops::CmpGT(ay, ax), Ops::Sub(Ops::Set(1.57079633f), r), r);
+	r = Ops::Select(Ops::CmpLT(x, Ops::Set(0.0f)), Ops::Sub(Ops::Set(3.14159265f), r), r);
+	r = Ops::Select(Ops::CmpLT(y, Ops::Set(0.0f)), Ops::Sub(Ops::Set(0.0f), r), r);
+	return r;
+}
+
+template <class Ops>
+inline void SinCos(typename Ops::F a, typename Ops::F& s, typename Ops::F& c)
+{
+	using F = typename Ops::F;
+	using M = typename Ops::M;
+
+	F k = Ops::Round(Ops::Mul(a, Ops::Set(0.63661977f)));
+	F r = Ops::Sub(a, Ops::Mul(k, Ops::Set(1.5703125f)));
+	r   = Ops::Sub(r, Ops::Mul(k, Ops::Set(4.837512969970703125e-4f)));
+	r   = Ops::Sub(r, Ops::Mul(k, Ops::Set(7.54978995489188216e-8f)));
+	F q = Ops::Sub(k, Ops::Mul(Ops::Floor(Ops::Mul(k, Ops::Set(0.25f))), Ops::Set(4.0f)));
+
+	F z  = Ops::Mul(r, r);
+	F ps = Ops::Set(-1.9515295891e-4f);
+	ps   = Ops::Add(Ops::Mul(ps, z), Ops::Set(8.3321608736e-3f));
+	ps   = Ops::Sub(Ops::Mul(ps, z), Ops::Set(1.6666654611e-1f));
+	ps   = Ops::Add(Ops::Mul(Ops::Mul(ps, z), r), r);
+	F pc = Ops::Set(2.443315711809948e-5f);
+	pc   = Ops::Sub(Ops::Mul(pc, z), Ops::Set(1.388731625493765e-3f));
+	pc   = Ops::Add(Ops::Mul(pc, z), Ops::Set(4.166664568298827e-2f));
+	pc   = Ops::Add(Ops::Sub(Ops::Set(1.0f), Ops::Mul(z, Ops::Set(0.5f))), Ops::Mul(Ops::Mul(pc, z), z));
+
+	M odd  = Ops::Or(Ops::CmpEQ(q, Ops::Set(1.0f)), Ops::CmpEQ(q, Ops::Set(3.0f)));
+	M sNeg = Ops::CmpGT(q, Ops::Set(1.5f));
+	M cNeg = Ops::Or(Ops::CmpEQ(q, Ops::Set(1.0f)), Ops::CmpEQ(q, Ops::Set(2.0f)));
+
+	s = Ops::Select(odd, pc, ps);
+	c = Ops::Select(odd, ps, pc);
+	s = Ops::Select(sNeg, Ops::Sub(Ops::Set(0.0f), s), s);
+	c = Ops::Select(cNeg, Ops::Sub(Ops::Set(0.0f), c), c);
+}
+
+template <class Ops, GrowthMode Mode>
+inline void Direction(typename Ops::F dx, typename Ops::F dy, typename Ops::F& c, typename Ops::F& s)
+{
+	using F = typename Ops::F;
+	using M = typename Ops::M;
+
+	if constexpr (Mode == GrowthMode::Trig)
+	{
+		SinCos<Ops>(Atan2<Ops>(dy, dx), s, c);
+	}
+	else
+	{
+		F l  = Ops::Sqrt(Ops::Add(Ops::Mul(dx, dx), Ops::Mul(dy, dy)));
+		M zr = Ops::CmpEQ(l, Ops::Set(0.0f));
+		c    = Ops::Select(zr, Ops::Set(1.0f), Ops::Div(dx, l));
+		s    = Ops::Select(zr, Ops::Set(0.0f), Ops::Div(dy, l));
+	}
+}
+
+// Points is the compile time point count, 0 reads it from lanes.points at run time.
+template <class Ops, GrowthMode Mode, size_t Points>
+inline size_t GrowNeuritesBlock(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t d)
+{
+	using F = typename Ops::F;
+	using M = typename Ops::M;
+
+	const size_t points = Points ? Points : lanes.points;
+	const size_t stride = lanes.stride;
+	float* const x      = lanes.x + d;
+	float* const y      = lanes.y + d;
+
+	F len       = Ops::Load(lanes.length + d);
+	F maxLength = Ops::Load(lanes.maxLength + d);
+	F remaining = Ops::Sub(maxLength, len);
+	F tipGrowth = Ops::Min(Ops::Load(growth + d), remaining);
+	M active    = Ops::CmpNE(tipGrowth, Ops::Set(0.0f));
+	size_t grown = Ops::Count(active);
+	if (!grown)
+		return 0;
+	F newLength = Ops::Select(Ops::CmpEQ(tipGrowth, remaining), maxLength, Ops::Add(len, tipGrowth));
+	Ops::Store(lanes.length + d, Ops::Select(active, newLength, len));
+	len = Ops::Div(len, Ops::Set(static_cast<float>(points - 1)));
+
+	Ops::Store(x, Ops::Select(active, Ops::Set(0.0f), Ops::Load(x)));
+	Ops::Store(y, Ops::Select(active, Ops::Set(0.0f), Ops::Load(y)));
+
+	const size_t last = points - 1;
+	F nx = Ops::Load(x + last * stride);
+	F ny = Ops::Load(y + last * stride);
+	for (size_t i = last; i > 1; --i)
+	{
+		F ox = Ops::Load(x + (i - 1) * stride);
+		F oy = Ops::Load(y + (i - 1) * stride);
+		F s, c;
+		Direction<Ops, Mode>(Ops::Sub(nx, ox), Ops::Sub(ny, oy), c, s);
+		nx = Ops::Select(active, Ops::Sub(nx, Ops::Mul(c, len)), ox);
+		ny = Ops::Select(active, Ops::Sub(ny, Ops::Mul(s, len)), oy);
+		Ops::Store(x + (i - 1) * stride, nx);
+		Ops::Store(y + (i - 1) * stride, ny);
+	}
+
+	F px = Ops::Load(x);
+	F py = Ops::Load(y);
+	for (size_t i = 1; i < points; ++i)
+	{
+		F ox = Ops::Load(x + i * stride);
+		F oy = Ops::Load(y + i * stride);
+		F s, c;
+		Direction<Ops, Mode>(Ops::Sub(ox, px), Ops::Sub(oy, py), c, s);
+		px = Ops::Select(active, Ops::Add(px, Ops::Mul(c, len)), ox);
+		py = Ops::Select(active, Ops::Add(py, Ops::Mul(s, len)), oy);
+		Ops::Store(x + i * stride, px);
+		Ops::Store(y + i * stride, py);
+	}
+
+	F bx = Ops::Load(x + (last - 1) * stride);
+	F by = Ops::Load(y + (last - 1) * stride);
+	F s, c;
+	if constexpr (Mode == GrowthMode::Trig)
+	{
+		SinCos<Ops>(Ops::Add(Atan2<Ops>(Ops::Sub(py, by), Ops::Sub(px, bx)), Ops::Load(dAngle + d)), s, c);
+	}
+	else
+	{
+		F ds, dc, ux, uy;
+		SinCos<Ops>(Ops::Load(dAngle + d), ds, dc);
+		Direction<Ops, Mode>(Ops::Sub(px, bx), Ops::Sub(py, by), ux, uy);
+		c = Ops::Sub(Ops::Mul(dc, ux), Ops::Mul(ds, uy));
+		s = Ops::Add(Ops::Mul(ds, ux), Ops::Mul(dc, uy));
+	}
+	F tipLen = Ops::Add(len, tipGrowth);
+	Ops::Store(x + last * stride, Ops::Select(active, Ops::Add(bx, Ops::Mul(c, tipLen)), px));
+	Ops::Store(y + last * stride, Ops::Select(active, Ops::Add(by, Ops::Mul(s, tipLen)), py));
+	return grown;
+}
+
+template <class Ops, GrowthMode Mode, size_t Points>
+inline size_t GrowNeuritesSIMD(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end)
+{
+	size_t grown = 0;
+	size_t d     = begin;
+	for (; d + Ops::Width <= end; d += Ops::Width)
+		grown += GrowNeuritesBlock<Ops, Mode, Points>(lanes, growth, dAngle, d);
+	if (d < end)
+		grown += GrowNeuritesScalar(lanes, growth, dAngle, d, end, Mode);
+	return grown;
+}
+
+template <class Ops, GrowthMode Mode>
+inline size_t GrowNeuritesPoints(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end)
+{
+	switch (lanes.points)
+	{
+	case 8: return GrowNeuritesSIMD<Ops, Mode, 8>(lanes, growth, dAngle, begin, end);
+	case 16: return GrowNeuritesSIMD<Ops, Mode, 16>(lanes, growth, dAngle, begin, end);
+	case 32: return GrowNeuritesSIMD<Ops, Mode, 32>(lanes, growth, dAngle, begin, end);
+	case 64: return GrowNeuritesSIMD<Ops, Mode, 64>(lanes, growth, dAngle, begin, end);
+	default: return GrowNeuritesSIMD<Ops, Mode, 0>(lanes, growth, dAngle, begin, end);
+	}
+}
+
+template <class Ops>
+inline size_t GrowNeuritesDispatch(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode)
+{
+	if (mode == GrowthMode::Trig)
+		return GrowNeuritesPoints<Ops, GrowthMode::Trig>(lanes, growth, dAngle, begin, end);
+	return GrowNeuritesPoints<Ops, GrowthMode::Vector>(lanes, growth, dAngle, begin, end);
+}
+
+template <class Ops>
+inline void RandomUniformSIMD(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1)
+{
+	using U = typename Ops::U;
+
+	size_t d = begin;
+	for (; d + Ops::Width <= end; d += Ops::Width)
+	{
+		U c0 = Ops::SetU(neuron);
+		U c1 = Ops::IotaU(static_cast<uint32_t>(d));
+		U c2 = Ops::SetU(static_cast<uint32_t>(step));
+		U c3 = Ops::SetU(static_cast<uint32_t>(step >> 32));
+		U k0 = Ops::SetU(static_cast<uint32_t>(seed));
+		U k1 = Ops::SetU(static_cast<uint32_t>(seed >> 32));
+		for (size_t round = 0; round < 10; ++round)
+		{
+			U hi0, lo0, hi1, lo1;
+			Ops::MulHiLo(c0, 0xD251'1F53, hi0, lo0);
+			Ops::MulHiLo(c2, 0xCD9E'8D57, hi1, lo1);
+			c0 = Ops::XorU(Ops::XorU(hi1, c1), k0);
+			c1 = lo1;
+			c2 = Ops::XorU(Ops::XorU(hi0, c3), k1);
+			c3 = lo0;
+			k0 = Ops::AddU(k0, Ops::SetU(0x9E37'79B9));
+			k1 = Ops::AddU(k1, Ops::SetU(0xBB67'AE85));
+		}
+		Ops::Store(u0 + d, Ops::ToUniform(c0));
+		Ops::Store(u1 + d, Ops::ToUniform(c1));
+	}
+	if (d < end)
+		RandomUniformBatchScalar(seed, neuron, step, d, end, u0, u1);
+}
+
+template <class Ops>
+inline void PropagateRowsSIMD(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end)
+{
+	using F = typename Ops::F;
+
+	for (size_t r = begin; r < end; ++r)
+	{
+		const uint32_t* index  = rows.index + rows.start[r];
+		const float*    weight = rows.weight + rows.start[r];
+		const size_t    count  = rows.count[r];
+
+		F      acc = Ops::Set(0.0f);
+		size_t k   = 0;
+		for (; k + Ops::Width <= count; k += Ops::Width)
+			acc = Ops::Add(acc, Ops::Mul(Ops::Load(weight + k), Ops::Gather(input, index + k)));
+		float sum = Ops::Sum(acc);
+		for (; k < count; ++k)
+			sum += weight[k] * input[index[k]];
+		output[r] = sum;
+	}
+}
+
+template <class Ops, bool Active>
+inline CableSoma EliminateCableBlock(const CableLanes& lanes, size_t d)
+{
+	using F = typename Ops::F;
+
+	const size_t stride      = lanes.stride;
+	const size_t last        = lanes.points - 1;
+	const F      capacitance = Ops::Set(lanes.capacitance);
+	const F      leakRest    = Ops::Set(lanes.leak * lanes.rest);
+	const F      leak        = Ops::Set(lanes.leak);
+	const F      axial       = Ops::Set(lanes.axial);
+	const F      minSegment  = Ops::Set(lanes.minSegment);
+	const F      half        = Ops::Set(0.5f);
+	const F      one         = Ops::Set(1.0f);
+
+	// The compartment beyond the tip does not exist, its conductance and segment are 0.
+	F segNext = Ops::Set(0.0f);
+	F gaNext  = Ops::Set(0.0f);
+	F fNext   = Ops::Set(0.0f);
+	F rNext   = Ops::Set(0.0f);
+	F nx      = Ops::Load(lanes.x + last * stride + d);
+	F ny      = Ops::Load(lanes.y + last * stride + d);
+	for (size_t i = last; i > 0; --i)
+	{
+		F px  = Ops::Load(lanes.x + (i - 1) * stride + d);
+		F py  = Ops::Load(lanes.y + (i - 1) * stride + d);
+		F dx  = Ops::Sub(nx, px);
+		F dy  = Ops::Sub(ny, py);
+		F seg = Ops::Max(Ops::Sqrt(Ops::Add(Ops::Mul(dx, dx), Ops::Mul(dy, dy))), minSegment);
+		F len = Ops::Mul(Ops::Add(seg, segNext), half);
+		F ga  = Ops::Div(axial, seg);
+
+		F v       = Ops::Load(lanes.v + i * stride + d);
+		F a       = Ops::Mul(capacitance, len);
+		F current = Ops::Load(lanes.input + i * stride + d);
+		if constexpr (Active)
+		{
+			F w     = Ops::Load(lanes.w + i * stride + d);
+			F cubic = Ops::Mul(Ops::Mul(v, Ops::Mul(v, v)), Ops::Set(1.0f / 3.0f));
+			current = Ops::Add(current, Ops::Mul(Ops::Mul(Ops::Set(lanes.excitability), len), Ops::Sub(Ops::Sub(v, cubic), w)));
+		}
+
+		F diag = Ops::Add(Ops::Add(a, Ops::Mul(leak, len)), Ops::Add(ga, Ops::Mul(gaNext, Ops::Sub(one, fNext))));
+		F rhs  = Ops::Add(Ops::Add(Ops::Mul(a, v), Ops::Mul(leakRest, len)), Ops::Add(current, Ops::Mul(gaNext, rNext)));
+		fNext  = Ops::Div(ga, diag);
+		rNext  = Ops::Div(rhs, diag);
+		Ops::Store(lanes.factor + i * stride + d, fNext);
+		Ops::Store(lanes.rhs + i * stride + d, rNext);
+
+		segNext = seg;
+		gaNext  = ga;
+		nx      = px;
+		ny      = py;
+	}
+	return { Ops::Sum(Ops::Mul(gaNext, Ops::Sub(one, fNext))), Ops::Sum(Ops::Mul(gaNext, rNext)) };
+}
+
+template <class Ops, bool Active>
+inline void SubstituteCableBlock(const CableLanes& lanes, float soma, size_t d)
+{
+	using F = typename Ops::F;
+
+	const size_t stride = lanes.stride;
+	F            prev   = Ops::Set(soma);
+	Ops::Store(lanes.v + d, prev);
+	for (size_t i = 1; i < lanes.points; ++i)
+	{
+		F v = Ops::Add(Ops::Load(lanes.rhs + i * stride + d), Ops::Mul(Ops::Load(lanes.factor + i * stride + d), prev));
+		Ops::Store(lanes.v + i * stride + d, v);
+		if constexpr (Active)
+		{
+			F w     = Ops::Load(lanes.w + i * stride + d);
+			F drift = Ops::Sub(Ops::Add(v, Ops::Set(c_CableRecoveryOffset)), Ops::Mul(w, Ops::Set(c_CableRecoveryScale)));
+			Ops::Store(lanes.w + i * stride + d, Ops::Add(w, Ops::Mul(Ops::Set(lanes.dt * lanes.recovery), drift)));
+		}
+		prev = v;
+	}
+}
+
+template <class Ops>
+inline CableSoma EliminateCableDispatch(const CableLanes& lanes, size_t begin, size_t end)
+{
+	CableSoma soma;
+	size_t    d = begin;
+	for (; d + Ops::Width <= end; d += Ops::Width)
+	{
+		CableSoma block = lanes.excitability != 0.0f ? EliminateCableBlock<Ops, true>(lanes, d) : EliminateCableBlock<Ops, false>(lanes, d);
+		soma.diag      += block.diag;
+		soma.rhs       += block.rhs;
+	}
+	if (d < end)
+	{
+		CableSoma tail  = EliminateCableScalar(lanes, d, end);
+		soma.diag      += tail.diag;
+		soma.rhs       += tail.rhs;
+	}
+	return soma;
+}
+
+template <class Ops>
+inline void SubstituteCableDispatch(const CableLanes& lanes, float soma, size_t begin, size_t end)
+{
+	size_t d = begin;
+	for (; d + Ops::Width <= end; d += Ops::Width)
+	{
+		if (lanes.excitability != 0.0f)
+			SubstituteCableBlock<Ops, true>(lanes, soma, d);
+		else
+			SubstituteCableBlock<Ops, false>(lanes, soma, d);
+	}
+	if (d < end)
+		SubstituteCableScalar(lanes, soma, d, end);
+}
@@ -0,0 +1,90 @@
+#include "GrowKernelSIMD.h"
+
+#include <smmintrin.h>
+
+struct SSE41Ops
+{
+	using F = __m128;
+	using M = __m128;
+
+	static constexpr size_t Width = 4;
+
+	static F Load(const float* p) { return _mm_loadu_ps(p); }
+	static void Store(float* p, F v) { _mm_storeu_ps(p, v); }
+	static F Set(float v) { return _mm_set1_ps(v); }
+
+	static F Add(F a, F b) { return _mm_add_ps(a, b); }
+	static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+	static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+	static F Div(F a, F b) { return _mm_div_ps(a, b); }
+	static F Min(F a, F b) { return _mm_min_ps(a, b); }
+	static F Max(F a, F b) { return _mm_max_ps(a, b); }
+	static F Sqrt(F a) { return _mm_sqrt_ps(a); }
+	static F Abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static F Round(F a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	static F Floor(F a) { return _mm_floor_ps(a); }
+
+	static M CmpEQ(F a, F b) { return _mm_cmpeq_ps(a, b); }
+	static M CmpNE(F a, F b) { return _mm_cmpneq_ps(a, b); }
+	static M CmpLT(F a, F b) { return _mm_cmplt_ps(a, b); }
+	static M CmpGT(F a, F b) { return _mm_cmpgt_ps(a, b); }
+	static M Or(M a, M b) { return _mm_or_ps(a, b); }
+	static F Select(M m, F a, F b) { return _mm_blendv_ps(b, a, m); }
+
+	static F Gather(const float* base, const uint32_t* index) { return _mm_setr_ps(base[index[0]], base[index[1]], base[index[2]], base[index[3]]); }
+	static float Sum(F a)
+	{
+		F h = _mm_hadd_ps(a, a);
+		return _mm_cvtss_f32(_mm_hadd_ps(h, h));
+	}
+
+	using U = __m128i;
+
+	static U SetU(uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+	static U IotaU(uint32_t base) { return _mm_add_epi32(SetU(base), _mm_setr_epi32(0, 1, 2, 3)); }
+	static U AddU(U a, U b) { return _mm_add_epi32(a, b); }
+	static U XorU(U a, U b) { return _mm_xor_si128(a, b); }
+	static F ToUniform(U a) { return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(a, 8)), _mm_set1_ps(1.0f / 16777216.0f)); }
+
+	static void MulHiLo(U a, uint32_t b, U& hi, U& lo)
+	{
+		U m    = SetU(b);
+		U even = _mm_mul_epu32(a, m);
+		U odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+		hi     = _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+		lo     = _mm_mullo_epi32(a, m);
+	}
+
+	static size_t Count(M m)
+	{
+		size_t count = 0;
+		for (int bits = _mm_movemask_ps(m); bits; bits &= bits - 1)
+			++count;
+		return count;
+	}
+};
+
+size_t GrowNeuritesSSE41(const NeuriteLanes& lanes, const float* growth, const float* dAngle, size_t begin, size_t end, GrowthMode mode)
+{
+	return GrowNeuritesDispatch<SSE41Ops>(lanes, growth, dAngle, begin, end, mode);
+}
+
+void RandomUniformBatchSSE41(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1)
+{
+	RandomUniformSIMD<SSE41Ops>(seed, neuron, step, begin, end, u0, u1);
+}
+
+void PropagateRowsSSE41(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end)
+{
+	PropagateRowsSIMD<SSE41Ops>(rows, input, output, begin, end);
+}
+
+CableSoma EliminateCableSSE41(const CableLanes& lanes, size_t begin, size_t end)
+{
+	return EliminateCableDispatch<SSE41Ops>(lanes, begin, end);
+}
+
+void SubstituteCableSSE41(const CableLanes& lanes, float soma, size_t begin, size_t end)
+{
+	SubstituteCableDispatch<SSE41Ops>(lanes, soma, begin, end);
+}
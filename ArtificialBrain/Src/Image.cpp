@@ -0,0 +1,32 @@
+#include "Image.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+
+bool WritePPM(const char* path, uint32_t width, uint32_t height, const uint8_t* rgb)
+{
+	FILE* file = std::fopen(path, "wb");
+	if (!file)
+		return false;
+
+	size_t size    = static_cast<size_t>(width) * height * 3;
+	bool   success = std::fprintf(file, "P6\n%u %u\n255\n", width, height) > 0 && std::fwrite(rgb, 1, size, file) == size;
+	return std::fclose(file) == 0 && success;
+}
+
+ImageDifference CompareImages(const uint8_t* lhs, const uint8_t* rhs, size_t size)
+{
+	ImageDifference difference;
+	uint64_t        sum = 0;
+	for (size_t i = 0; i < size; ++i)
+	{
+		uint8_t delta         = static_cast<uint8_t>(std::abs(lhs[i] - rhs[i]));
+		sum                  += delta;
+		difference.max        = std::max(difference.max, delta);
+		difference.differing += delta != 0;
+	}
+	difference.mean = size ? static_cast<double>(sum) / size : 0.0;
+	return difference;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Writes tightly packed 8 bit RGB rows, top row first, as a binary PPM (P6). Returns false on IO failure.
+bool WritePPM(const char* path, uint32_t width, uint32_t height, const uint8_t* rgb);
+
+struct ImageDifference
+{
+	double  mean      = 0.0; // Absolute difference per channel.
+	uint8_t max       = 0;
+	size_t  differing = 0; // Channels that are not equal.
+};
+
+// Compares two tightly packed images of size bytes each.
+ImageDifference CompareImages(const uint8_t* lhs, const uint8_t* rhs, size_t size);
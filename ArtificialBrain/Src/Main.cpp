@@ -1,100 +1,332 @@
 #include "Brain.h"
-
+#include "Cable.h"
+#include "Checkpoint.h"
+#include "GrowKernel.h"
+#include "Image.h"
+#include "Random.h"
+#include "Rasterizer.h"
+#include "Renderer.h"
+#include "Simd.h"
+#include "Simulation.h"
+#include "Spiking.h"
+#include "SynapseMatrix.h"
+#include "Synapses.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <glad/glad.h>
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 
-const char s_VertexShaderSource[]   = R"glsl(#version 460 core
-
-layout(location = 0) in vec2 pos;
-layout(location = 1) in vec3 col;
-
-layout(location = 0) out vec3 passCol;
-
-layout(location = 0) uniform vec2 camPos;
-layout(location = 1) uniform vec2 camScale;
+// Spiking ticks simulated per growth step, 1 ms.
+constexpr uint32_t c_SpikeTicksPerStep = 10;
+// Cable steps per growth step, one membrane time constant with the default parameters.
+constexpr size_t c_CableStepsPerStep = 20;
 
-void main()
+enum class RecordBackend
 {
-	gl_Position = vec4((pos - camPos) * camScale, 0.0f, 1.0f);
-	passCol     = col;
-}
-)glsl";
-const char s_FragmentShaderSource[] = R"glsl(#version 460 core
-
-layout(location = 0) in vec3 passCol;
-
-layout(location = 0) out vec4 outColor;
-
-void main()
-{
-	outColor = vec4(passCol, 1.0f);
-}
-)glsl";
+	GL,
+	CPU,
+	Compare // Writes the GL frames and reports how far the CPU rasterizer is from them.
+};
 
-struct Vertex
+struct RecordOptions
 {
-	Point pos;
-	float r, g, b;
+	std::string   directory;
+	RecordBackend backend = RecordBackend::GL;
+	size_t        every   = 10;
+	uint32_t      width   = 1280;
+	uint32_t      height  = 720;
+	float         spacing = 20.0f; // Population grid spacing, used to frame the camera.
 };
 
-GLuint CompileProgram(const char* vertexShaderSource, const char* fragmentShaderSource);
+// Vertical scale that fits a square population grid of the given spacing into the view.
+float       CameraScale(size_t neuronCount, float spacing);
+GLFWwindow* CreateContextWindow(int width, int height, bool visible);
+int         RunRecording(NeuronPopulation& population, ThreadPool& pool, RenderMode renderMode, NeuronShape shape, size_t steps, const RecordOptions& options);
+int         RunHeadless(NeuronPopulation& population, ThreadPool& pool, size_t steps, SynapseFormation* synapses, SpikingNetwork* spiking, const CableParams* cable);
+int         SaveCheckpoint(const NeuronPopulation& population, const std::string& path);
 
 int main(int argc, char** argv)
 {
-	if (!glfwInit())
-		return 1;
-
-	glfwDefaultWindowHints();
-	glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+	size_t        neuronCount   = 1;
+	SimdKernel    kernel        = BestSimdKernel();
+	GrowthMode    mode          = GrowthMode::Vector;
+	size_t        threadCount   = 0;
+	uint64_t      seed          = RandomSeedFromDevice();
+	bool          headless      = false;
+	size_t        steps         = 1000;
+	double        sps           = 60.0;
+	NeuronShape   shape;
+	RenderMode    renderMode    = RenderMode::Compact;
+	RecordOptions record;
+	std::string   loadPath;
+	std::string   savePath;
+	float         contactRadius = 0.0f;
+	float         spacing       = 20.0f;
+	bool          spiking       = false;
+	bool          cable         = false;
+	CableParams   cableParams;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		if (arg.starts_with("--kernel="))
+		{
+			if (!ParseSimdKernel(argv[i] + 9, kernel))
+			{
+				std::printf("Unknown kernel '%s', expected scalar, sse4.1, avx2 or avx512\n", argv[i] + 9);
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--mode="))
+		{
+			if (!ParseGrowthMode(argv[i] + 7, mode))
+			{
+				std::printf("Unknown growth mode '%s', expected trig or vector\n", argv[i] + 7);
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--seed="))
+		{
+			seed = std::strtoull(argv[i] + 7, nullptr, 10);
+		}
+		else if (arg.starts_with("--threads="))
+		{
+			threadCount = std::strtoull(argv[i] + 10, nullptr, 10);
+		}
+		else if (arg == "--headless")
+		{
+			headless = true;
+		}
+		else if (arg.starts_with("--steps="))
+		{
+			steps = std::strtoull(argv[i] + 8, nullptr, 10);
+		}
+		else if (arg.starts_with("--sps="))
+		{
+			sps = std::strtod(argv[i] + 6, nullptr);
+		}
+		else if (arg.starts_with("--dendrites="))
+		{
+			shape.dendrites = std::max<size_t>(std::strtoull(argv[i] + 12, nullptr, 10), 1);
+		}
+		else if (arg.starts_with("--render="))
+		{
+			std::string_view name = arg.substr(9);
+			if (name == "lines")
+			{
+				renderMode = RenderMode::Lines;
+			}
+			else if (name == "compact")
+			{
+				renderMode = RenderMode::Compact;
+			}
+			else
+			{
+				std::printf("Unknown render mode '%s', expected lines or compact\n", argv[i] + 9);
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--record="))
+		{
+			record.directory = argv[i] + 9;
+		}
+		else if (arg.starts_with("--record-backend="))
+		{
+			std::string_view name = arg.substr(17);
+			if (name == "gl")
+			{
+				record.backend = RecordBackend::GL;
+			}
+			else if (name == "cpu")
+			{
+				record.backend = RecordBackend::CPU;
+			}
+			else if (name == "compare")
+			{
+				record.backend = RecordBackend::Compare;
+			}
+			else
+			{
+				std::printf("Unknown record backend '%s', expected gl, cpu or compare\n", argv[i] + 17);
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--record-every="))
+		{
+			record.every = std::max<size_t>(std::strtoull(argv[i] + 15, nullptr, 10), 1);
+		}
+		else if (arg.starts_with("--record-size="))
+		{
+			unsigned width = 0, height = 0;
+			if (std::sscanf(argv[i] + 14, "%ux%u", &width, &height) != 2 || !width || !height)
+			{
+				std::printf("Invalid record size '%s', expected WIDTHxHEIGHT\n", argv[i] + 14);
+				return 1;
+			}
+			record.width  = width;
+			record.height = height;
+		}
+		else if (arg.starts_with("--load="))
+		{
+			loadPath = argv[i] + 7;
+		}
+		else if (arg.starts_with("--save="))
+		{
+			savePath = argv[i] + 7;
+		}
+		else if (arg.starts_with("--spacing="))
+		{
+			spacing = std::strtof(argv[i] + 10, nullptr);
+		}
+		else if (arg.starts_with("--synapses="))
+		{
+			contactRadius = std::strtof(argv[i] + 11, nullptr);
+		}
+		else if (arg == "--spiking")
+		{
+			spiking = true;
+		}
+		else if (arg.starts_with("--cable="))
+		{
+			cable = true;
+			if (arg == "--cable=active")
+			{
+				cableParams = ActiveCableParams();
+			}
+			else if (arg != "--cable=passive")
+			{
+				std::printf("Unknown cable membrane '%s', expected passive or active\n", argv[i] + 8);
+				return 1;
+			}
+		}
+		else if (arg.starts_with("--points="))
+		{
+			shape.points = std::max<size_t>(std::strtoull(argv[i] + 9, nullptr, 10), 3);
+		}
+		else if (!arg.empty() && arg.find_first_not_of("0123456789") == std::string_view::npos)
+		{
+			neuronCount = std::max<size_t>(std::strtoull(argv[i], nullptr, 10), 1);
+		}
+		else
+		{
+			std::printf("Unknown argument '%s', expected an option or a neuron count\n", argv[i]);
+			return 1;
+		}
+	}
 
-	auto window = glfwCreateWindow(1280, 720, "Artificial Brain", nullptr, nullptr);
-	if (!window)
+	// Synapses, spikes and cables are only simulated by the headless loop.
+	if (!headless && (contactRadius > 0.0f || spiking || cable))
+	{
+		std::printf("--synapses, --spiking and --cable need --headless\n");
 		return 1;
+	}
+	if (headless && !record.directory.empty())
+	{
+		std::printf("--record and --headless cannot be combined, a recording runs without a window already\n");
+		return 1;
+	}
+	if (spiking && contactRadius <= 0.0f)
+	{
+		std::printf("--spiking needs synapses, set a contact radius with --synapses=<radius>\n");
+		return 1;
+	}
 
-	glfwMakeContextCurrent(window);
-	glfwSwapInterval(1);
+	if (!loadPath.empty())
+	{
+		CheckpointHeader header;
+		if (!ReadCheckpointHeader(loadPath.c_str(), header) || header.kind != CheckpointKind::Population)
+		{
+			std::printf("'%s' is not a population checkpoint\n", loadPath.c_str());
+			return 1;
+		}
+		shape       = { static_cast<size_t>(header.dendrites), static_cast<size_t>(header.points) };
+		neuronCount = static_cast<size_t>(header.count);
+	}
 
-	if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress))
+	if (contactRadius > 0.0f && !IsGridShapeSupported(shape, neuronCount))
+	{
+		std::printf("Synapses support at most %zu dendrites of %zu points and %llu points in total\n", c_GridMaxDendrites, c_GridMaxPoints, static_cast<unsigned long long>(c_GridMaxTotal));
 		return 1;
+	}
 
-	GLuint shaderProgram = CompileProgram(s_VertexShaderSource, s_FragmentShaderSource);
-	if (!shaderProgram)
-		return 1;
+	if (!IsSimdKernelSupported(kernel))
+	{
+		std::printf("Kernel %s is not supported on this CPU, using scalar\n", SimdKernelName(kernel));
+		kernel = SimdKernel::Scalar;
+	}
+	// The tolerance only concerns the growth trig, the other kernels keep the requested ISA.
+	SetSimdKernel(kernel);
+	float kernelError = VerifyGrowKernel(kernel, mode, shape);
+	if (kernelError > c_GrowKernelTolerance)
+	{
+		std::printf("Kernel %s in %s mode deviates from scalar trig by %g, growing on scalar\n", SimdKernelName(kernel), GrowthModeName(mode), kernelError);
+		kernel = SimdKernel::Scalar;
+	}
+	SetGrowKernel(kernel);
+	SetGrowthMode(mode);
+	std::printf("Using %s grow kernel in %s mode, %s for the other kernels, %zu dendrites of %zu points, seed %llu\n", SimdKernelName(kernel), GrowthModeName(mode), SimdKernelName(GetSimdKernel()), shape.dendrites, shape.points, static_cast<unsigned long long>(seed));
 
-	GLuint vaos[1];
-	GLuint vbos[1];
+	ThreadPool       pool(threadCount);
+	NeuronPopulation population;
+	if (loadPath.empty())
+	{
+		InitPopulation(population, neuronCount, spacing, seed, pool, shape);
+	}
+	else
+	{
+		if (!LoadPopulation(loadPath.c_str(), population) || population.neurons.empty())
+		{
+			std::printf("Failed to load checkpoint '%s'\n", loadPath.c_str());
+			return 1;
+		}
+		neuronCount = population.neurons.size();
+		std::printf("Loaded %zu neurons, %zu still growing, from %s\n", neuronCount, population.active.size(), loadPath.c_str());
+	}
 
-	std::vector<Vertex> lineSegments(2 * 256 * 31);
+	if (headless || !record.directory.empty())
+	{
+		record.spacing = spacing;
+
+		std::unique_ptr<SynapseFormation> synapses;
+		std::unique_ptr<SpikingNetwork>   network;
+		if (contactRadius > 0.0f)
+			synapses = std::make_unique<SynapseFormation>(contactRadius);
+		if (spiking)
+			network = std::make_unique<SpikingNetwork>();
+		int status = headless ? RunHeadless(population, pool, steps, synapses.get(), network.get(), cable ? &cableParams : nullptr) : RunRecording(population, pool, renderMode, shape, steps, record);
+		return status ? status : SaveCheckpoint(population, savePath);
+	}
 
-	glCreateVertexArrays(1, vaos);
-	glCreateBuffers(1, vbos);
+	auto window = CreateContextWindow(1280, 720, true);
+	if (!window)
+		return 1;
 
-	glBindVertexArray(vaos[0]);
-	glBindBuffer(GL_ARRAY_BUFFER, vbos[0]);
-	glBufferData(GL_ARRAY_BUFFER, lineSegments.size() * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, r));
-	glEnableVertexAttribArray(0);
-	glEnableVertexAttribArray(1);
+	glfwSwapInterval(1);
 
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	auto renderer = std::make_unique<Renderer>(renderMode, neuronCount, shape);
+	if (!renderer->Valid())
+		return 1;
 
 	float camX   = 0.0f;
 	float camY   = 0.0f;
-	float scaleY = 1.0f / 10.0f;
+	float scaleY = CameraScale(neuronCount, spacing);
 	float scaleX = scaleY;
 
-	Neuron& neuron = *new Neuron();
-	InitNeuron(neuron);
+	auto     simulation   = std::make_unique<Simulation>(population, pool, sps);
+	double   titleTime    = glfwGetTime();
+	uint64_t renderedStep = 0;
 
 	while (!glfwWindowShouldClose(window))
 	{
@@ -106,136 +338,302 @@ int main(int argc, char** argv)
 		glViewport(0, 0, width, height);
 		scaleX = scaleY * height / width;
 
-		GrowNeuron(neuron);
-		size_t index = 0;
-		{
-			for (size_t i = 0; i < 256; ++i)
-			{
-				float r = 0.0f;
-				float g = 0.0f;
-				float b = 0.0f;
-
-				if (neuron.longest == i)
-				{
-					r = 1.00f;
-					g = 0.05f;
-					b = 0.05f;
-				}
-				else if (neuron.furthest == i)
-				{
-					r = 0.05f;
-					g = 1.00f;
-					b = 0.05f;
-				}
-				else
-				{
-					r = 0.05f;
-					g = 0.05f;
-					b = 1.00f;
-				}
-
-				for (size_t j = 0; j < 31; ++j)
-				{
-					lineSegments[index++] = { neuron.dendrites[i].points[j], r, g, b };
-					lineSegments[index++] = { neuron.dendrites[i].points[j + 1], r, g, b };
-				}
-			}
-			glBindBuffer(GL_ARRAY_BUFFER, vbos[0]);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, lineSegments.size() * sizeof(Vertex), lineSegments.data());
-
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		const PopulationSnapshot* snapshot = simulation->Latest();
+		if (snapshot && snapshot->step != renderedStep)
+		{
+			renderedStep = snapshot->step;
+			renderer->Upload(snapshot->neurons);
+		}
+
+		double time = glfwGetTime();
+		if (snapshot && time - titleTime >= 1.0)
+		{
+			char title[160];
+			std::snprintf(title, sizeof(title), "Artificial Brain - %zu neurons, %zu threads, step %llu, %.1f steps/s, %.3g segments/s", neuronCount, pool.ThreadCount(), static_cast<unsigned long long>(snapshot->step), snapshot->stepsPerSecond, snapshot->segmentsPerSecond);
+			glfwSetWindowTitle(window, title);
+			titleTime = time;
 		}
 
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		glUseProgram(shaderProgram);
-		glUniform2f(0, camX, camY);
-		glUniform2f(1, scaleX, scaleY);
-
-		glBindVertexArray(vaos[0]);
-		glDrawArrays(GL_LINES, 0, index);
-
-		glBindVertexArray(0);
-		glUseProgram(0);
+		if (renderedStep)
+			renderer->Draw(camX, camY, scaleX, scaleY);
 
 		glfwSwapBuffers(window);
 	}
-	delete &neuron;
-
-	glDeleteProgram(shaderProgram);
 
+	simulation.reset();
+	renderer.reset();
 	glfwDestroyWindow(window);
 	glfwTerminate();
+	return SaveCheckpoint(population, savePath);
+}
+
+int SaveCheckpoint(const NeuronPopulation& population, const std::string& path)
+{
+	if (path.empty())
+		return 0;
+	if (!SavePopulation(path.c_str(), population))
+	{
+		std::printf("Failed to save checkpoint '%s'\n", path.c_str());
+		return 1;
+	}
+	std::printf("Saved %zu neurons, %zu still growing, to %s\n", population.neurons.size(), population.active.size(), path.c_str());
 	return 0;
 }
 
-GLuint CompileProgram(const char* vertexShaderSource, const char* fragmentShaderSource)
+float CameraScale(size_t neuronCount, float spacing)
 {
-	GLuint vertexShader   = glCreateShader(GL_VERTEX_SHADER);
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	return 1.0f / (0.5f * spacing * std::ceil(std::sqrt(static_cast<float>(neuronCount))));
+}
+
+GLFWwindow* CreateContextWindow(int width, int height, bool visible)
+{
+	auto create = [&]() -> GLFWwindow* {
+		glfwDefaultWindowHints();
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+		glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+		if (!visible && glfwGetPlatform() == GLFW_PLATFORM_NULL)
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+		return glfwCreateWindow(width, height, "Artificial Brain", nullptr, nullptr);
+	};
+
+	GLFWwindow* window = glfwInit() ? create() : nullptr;
+	if (!window && !visible)
+	{
+		// No display, fall back to the null platform with an OSMesa (llvmpipe) context.
+		glfwTerminate();
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+		window = glfwInit() ? create() : nullptr;
+	}
+	if (!window)
+	{
+		glfwTerminate();
+		return nullptr;
+	}
+
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress))
+	{
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return nullptr;
+	}
+	return window;
+}
 
-	const char* sources[] { vertexShaderSource };
-	glShaderSource(vertexShader, 1, sources, nullptr);
-	sources[0] = fragmentShaderSource;
-	glShaderSource(fragmentShader, 1, sources, nullptr);
-	glCompileShader(vertexShader);
-	glCompileShader(fragmentShader);
+int RunRecording(NeuronPopulation& population, ThreadPool& pool, RenderMode renderMode, NeuronShape shape, size_t steps, const RecordOptions& options)
+{
+	using Clock = std::chrono::steady_clock;
 
+	std::error_code error;
+	std::filesystem::create_directories(options.directory, error);
+	if (error)
 	{
-		bool failed = false;
+		std::printf("Failed to create '%s': %s\n", options.directory.c_str(), error.message().c_str());
+		return 1;
+	}
 
-		int status = 0;
-		glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &status);
-		if (!status)
+	GLFWwindow* window = nullptr;
+	if (options.backend != RecordBackend::CPU)
+	{
+		window = CreateContextWindow(static_cast<int>(options.width), static_cast<int>(options.height), false);
+		if (!window)
 		{
-			int length = 0;
-			glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &length);
-			std::string log(length, '\0');
-			glGetShaderInfoLog(vertexShader, length, nullptr, log.data());
-			std::printf("VertexShader log: %s\n", log.c_str());
-			failed = true;
+			std::printf("Failed to create an offscreen GL 4.6 context, try --record-backend=cpu\n");
+			return 1;
 		}
+	}
 
-		glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &status);
-		if (!status)
+	int status = 0;
+	{
+		size_t neuronCount = population.neurons.size();
+		float  scaleY      = CameraScale(neuronCount, options.spacing);
+		float  scaleX      = scaleY * options.height / options.width;
+
+		std::unique_ptr<Renderer>        renderer;
+		std::unique_ptr<OffscreenTarget> target;
+		std::unique_ptr<LineRasterizer>  rasterizer;
+		if (window)
 		{
-			int length = 0;
-			glGetShaderiv(fragmentShader, GL_INFO_LOG_LENGTH, &length);
-			std::string log(length, '\0');
-			glGetShaderInfoLog(fragmentShader, length, nullptr, log.data());
-			std::printf("FragmentShader log: %s\n", log.c_str());
-			failed = true;
+			renderer = std::make_unique<Renderer>(renderMode, neuronCount, shape);
+			target   = std::make_unique<OffscreenTarget>(options.width, options.height);
+			if (!renderer->Valid())
+				status = 1;
 		}
+		if (!window || options.backend == RecordBackend::Compare)
+			rasterizer = std::make_unique<LineRasterizer>(options.width, options.height);
 
-		if (failed)
+		std::printf("Recording %zu steps of %zu neurons every %zu steps at %ux%u with %s to %s\n", steps, neuronCount, options.every, options.width, options.height, window ? "gl" : "cpu", options.directory.c_str());
+
+		std::vector<uint8_t> rgb;
+		std::vector<uint8_t> cpuRgb;
+		size_t               frames     = 0;
+		double               renderTime = 0.0;
+		auto                 start      = Clock::now();
+		for (size_t step = 0; status == 0 && step <= steps; ++step)
 		{
-			glDeleteShader(vertexShader);
-			glDeleteShader(fragmentShader);
-			return 0;
+			if (step > 0)
+				GrowPopulation(population, pool);
+			if (step % options.every != 0 && step != steps)
+				continue;
+
+			auto frameStart = Clock::now();
+			if (renderer)
+			{
+				renderer->Upload(population.neurons);
+				target->Bind();
+				glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT);
+				renderer->Draw(0.0f, 0.0f, scaleX, scaleY);
+				target->Read(rgb);
+			}
+			if (rasterizer)
+			{
+				rasterizer->Render(population.neurons, { 0.0f, 0.0f }, { scaleX, scaleY }, pool);
+				rasterizer->Resolve(renderer ? cpuRgb : rgb);
+			}
+			if (renderer && rasterizer)
+			{
+				// The frames differ in how lines are anti-aliased, large errors point at the camera or colors.
+				ImageDifference difference = CompareImages(rgb.data(), cpuRgb.data(), rgb.size());
+				std::printf("Frame %zu: cpu differs from gl by %.3f on average, at most %u, in %.2f%% of the channels\n", step, difference.mean, static_cast<unsigned>(difference.max), 100.0 * difference.differing / rgb.size());
+			}
+
+			char path[1024];
+			std::snprintf(path, sizeof(path), "%s/frame_%06zu.ppm", options.directory.c_str(), step);
+			if (!WritePPM(path, options.width, options.height, rgb.data()))
+			{
+				std::printf("Failed to write '%s'\n", path);
+				status = 1;
+			}
+			renderTime += std::chrono::duration<double>(Clock::now() - frameStart).count();
+			++frames;
 		}
+
+		double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		std::printf("Wrote %zu frames in %.3f s: %.2f frames/s rendering, %.2f frames/s overall\n", frames, elapsed, frames / renderTime, frames / elapsed);
+		if (window)
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
-	GLuint program = glCreateProgram();
-	glAttachShader(program, vertexShader);
-	glAttachShader(program, fragmentShader);
-	glLinkProgram(program);
-	glDetachShader(program, vertexShader);
-	glDetachShader(program, fragmentShader);
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-	int status = 0;
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
-	if (!status)
-	{
-		int length = 0;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
-		std::string log(length, '\0');
-		glGetProgramInfoLog(program, length, nullptr, log.data());
-		std::printf("Linkage log: %s\n", log.data());
-		glDeleteProgram(program);
-		return 0;
+	if (window)
+	{
+		glfwDestroyWindow(window);
+		glfwTerminate();
+	}
+	return status;
+}
+
+int RunHeadless(NeuronPopulation& population, ThreadPool& pool, size_t steps, SynapseFormation* synapses, SpikingNetwork* spiking, const CableParams* cable)
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::printf("Running %zu steps of %zu neurons on %zu threads\n", steps, population.neurons.size(), pool.ThreadCount());
+
+	// Signals start at neuron 0, which is held active, and spread through tanh(weighted input).
+	// With spiking, neuron 0 is driven to fire every step and spikes travel along the synapses.
+	SynapseMatrix      matrix(population.neurons.size());
+	std::vector<float> activity(population.neurons.size());
+	std::vector<float> input(population.neurons.size());
+	if (!activity.empty())
+		activity[0] = 1.0f;
+	if (spiking)
+		spiking->Resize(population);
+
+	// The membrane of neuron 0 is driven by current into all of its dendrite tips.
+	std::vector<CableState> cables;
+	if (cable)
+	{
+		InitCables(cables, population, *cable);
+		const NeuronSoA& neuron = population.neurons[0];
+		for (size_t d = 0; d < neuron.Dendrites(); ++d)
+			cables[0].Input(neuron.Points() - 1)[d] = 0.2f;
+	}
+	const size_t compartmentsPerStep = cable ? c_CableStepsPerStep * population.neurons.size() * population.neurons[0].Dendrites() * (population.neurons[0].Points() - 1) : 0;
+
+	size_t segments        = 0;
+	size_t tested          = 0;
+	size_t propagated      = 0;
+	size_t statsSteps      = 0;
+	size_t statsSegments   = 0;
+	size_t statsTested     = 0;
+	size_t statsFormed     = 0;
+	size_t statsPropagated = 0;
+	size_t compartments    = 0;
+	auto   start           = Clock::now();
+	auto   statsTime       = start;
+	for (size_t step = 0; step < steps; ++step)
+	{
+		size_t grown   = GrowPopulation(population, pool);
+		segments      += grown;
+		statsSegments += grown;
+		++statsSteps;
+		if (synapses)
+		{
+			size_t formed  = synapses->Step(population, pool);
+			statsFormed   += formed;
+			statsTested   += synapses->Tested();
+			tested        += synapses->Tested();
+
+			const auto& all = synapses->Synapses();
+			matrix.Insert(all.data() + all.size() - formed, formed, c_SynapseWeight);
+			matrix.Commit();
+			size_t signals = matrix.Size();
+			if (spiking)
+			{
+				spiking->Stimulate(0, spiking->Params().threshold);
+				signals = spiking->Run(matrix, c_SpikeTicksPerStep, pool);
+			}
+			else
+			{
+				PropagateSignals(matrix, activity.data(), input.data(), pool);
+				for (size_t n = 1; n < activity.size(); ++n)
+					activity[n] = std::tanh(input[n]);
+			}
+			propagated      += signals;
+			statsPropagated += signals;
+		}
+		if (cable)
+		{
+			for (size_t i = 0; i < c_CableStepsPerStep; ++i)
+				StepCables(cables, population, *cable, pool);
+			compartments += compartmentsPerStep;
+		}
+
+		auto   time    = Clock::now();
+		double elapsed = std::chrono::duration<double>(time - statsTime).count();
+		if (elapsed >= 1.0)
+		{
+			if (synapses)
+				std::printf("Step %zu: %.1f steps/s, %.3g segments/s, %.3g contacts tested/s, %.3g synapses formed/s, %.3g %s/s, %zu synapses\n", step + 1, statsSteps / elapsed, statsSegments / elapsed, statsTested / elapsed, statsFormed / elapsed, statsPropagated / elapsed, spiking ? "spike events" : "synapses propagated", synapses->Synapses().size());
+			else
+				std::printf("Step %zu: %.1f steps/s, %.3g segments/s\n", step + 1, statsSteps / elapsed, statsSegments / elapsed);
+			statsTime       = time;
+			statsSteps      = 0;
+			statsSegments   = 0;
+			statsTested     = 0;
+			statsFormed     = 0;
+			statsPropagated = 0;
+		}
 	}
 
-	return program;
-}
\ No newline at end of file
+	double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	std::printf("Finished %zu steps in %.3f s: %.1f steps/s, %.3g segments/s\n", steps, elapsed, steps / elapsed, segments / elapsed);
+	if (spiking)
+	{
+		std::printf("Formed %zu synapses, %.3g contacts tested/s, %.3g spike events/s, %zu spikes, %zu events pending\n", synapses->Synapses().size(), tested / elapsed, propagated / elapsed, spiking->Spikes(), spiking->Pending());
+	}
+	else if (synapses)
+	{
+		size_t active = std::count_if(activity.begin(), activity.end(), [](float a) { return a > 0.0f; });
+		std::printf("Formed %zu synapses, %.3g contacts tested/s, %.3g synapses propagated/s, %zu neurons reached\n", synapses->Synapses().size(), tested / elapsed, propagated / elapsed, active);
+	}
+	if (cable)
+		std::printf("Cable: %.3g compartment steps/s, soma of neuron 0 at %.3f\n", compartments / elapsed, cables[0].soma);
+	return 0;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cmath>
+
+// Header only so every translation unit can inline and vectorize the point math.
+// Never include this from the per ISA grow kernel units.
+
+struct Point
+{
+	float x, y;
+};
+
+constexpr Point operator+(Point lhs, Point rhs)
+{
+	return { lhs.x + rhs.x, lhs.y + rhs.y };
+}
+constexpr Point operator-(Point lhs, Point rhs)
+{
+	return { lhs.x - rhs.x, lhs.y - rhs.y };
+}
+constexpr Point operator*(Point lhs, Point rhs)
+{
+	return { lhs.x * rhs.x, lhs.y * rhs.y };
+}
+constexpr Point operator*(float lhs, Point rhs)
+{
+	return { lhs * rhs.x, lhs * rhs.y };
+}
+constexpr Point operator*(Point lhs, float rhs)
+{
+	return { lhs.x * rhs, lhs.y * rhs };
+}
+constexpr Point operator/(Point lhs, Point rhs)
+{
+	return { lhs.x / rhs.x, lhs.y / rhs.y };
+}
+constexpr Point operator/(float lhs, Point rhs)
+{
+	return { lhs / rhs.x, lhs / rhs.y };
+}
+constexpr Point operator/(Point lhs, float rhs)
+{
+	return { lhs.x / rhs, lhs.y / rhs };
+}
+
+constexpr Point& operator+=(Point& lhs, Point rhs)
+{
+	return lhs = lhs + rhs;
+}
+constexpr Point& operator-=(Point& lhs, Point rhs)
+{
+	return lhs = lhs - rhs;
+}
+constexpr Point& operator*=(Point& lhs, Point rhs)
+{
+	return lhs = lhs * rhs;
+}
+constexpr Point& operator*=(Point& lhs, float rhs)
+{
+	return lhs = lhs * rhs;
+}
+constexpr Point& operator/=(Point& lhs, Point rhs)
+{
+	return lhs = lhs / rhs;
+}
+constexpr Point& operator/=(Point& lhs, float rhs)
+{
+	return lhs = lhs / rhs;
+}
+
+constexpr float lengthSquared(Point p)
+{
+	return p.x * p.x + p.y * p.y;
+}
+
+inline float length(Point p)
+{
+	return sqrtf(lengthSquared(p));
+}
+
+inline float angle(Point p)
+{
+	return atan2f(p.y, p.x);
+}
+
+inline Point fromAngle(float angle)
+{
+	return { cosf(angle), sinf(angle) };
+}
+
+inline Point direction(Point p)
+{
+	float len = length(p);
+	if (len == 0.0f)
+		return { 1.0f, 0.0f };
+	return p / len;
+}
+
+constexpr Point rotate(Point p, float cosAngle, float sinAngle)
+{
+	return { cosAngle * p.x - sinAngle * p.y, sinAngle * p.x + cosAngle * p.y };
+}
+
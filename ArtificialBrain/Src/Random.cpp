@@ -0,0 +1,34 @@
+#include "Random.h"
+#include "GrowKernel.h"
+
+#include <random>
+
+// Same counter layout as RandomUniform, the SIMD kernels are checked against this.
+void RandomUniformBatchScalar(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1)
+{
+	for (size_t d = begin; d < end; ++d)
+	{
+		uint32_t counter[4] { neuron, static_cast<uint32_t>(d), static_cast<uint32_t>(step), static_cast<uint32_t>(step >> 32) };
+		uint32_t bits[4];
+		Philox4x32(counter, seed, bits);
+		u0[d] = UniformFloat(bits[0], 0.0f, 1.0f);
+		u1[d] = UniformFloat(bits[1], 0.0f, 1.0f);
+	}
+}
+
+void RandomUniformBatch(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1)
+{
+	switch (GetGrowKernel())
+	{
+	case SimdKernel::Scalar: RandomUniformBatchScalar(seed, neuron, step, begin, end, u0, u1); break;
+	case SimdKernel::SSE41: RandomUniformBatchSSE41(seed, neuron, step, begin, end, u0, u1); break;
+	case SimdKernel::AVX2: RandomUniformBatchAVX2(seed, neuron, step, begin, end, u0, u1); break;
+	case SimdKernel::AVX512: RandomUniformBatchAVX512(seed, neuron, step, begin, end, u0, u1); break;
+	}
+}
+
+uint64_t RandomSeedFromDevice()
+{
+	std::random_device device;
+	return static_cast<uint64_t>(device()) << 32 | device();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint32_t c_RandomNeuronStream = 0xFFFF'FFFF;
+constexpr uint64_t c_RandomInitStep     = 0xFFFF'FFFF'FFFF'FFFF;
+
+inline void Philox4x32(const uint32_t (&counter)[4], uint64_t seed, uint32_t (&out)[4])
+{
+	uint32_t c0 = counter[0];
+	uint32_t c1 = counter[1];
+	uint32_t c2 = counter[2];
+	uint32_t c3 = counter[3];
+	uint32_t k0 = static_cast<uint32_t>(seed);
+	uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+	for (size_t round = 0; round < 10; ++round)
+	{
+		uint64_t p0 = static_cast<uint64_t>(0xD251'1F53) * c0;
+		uint64_t p1 = static_cast<uint64_t>(0xCD9E'8D57) * c2;
+		c0          = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+		c1          = static_cast<uint32_t>(p1);
+		c2          = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+		c3          = static_cast<uint32_t>(p0);
+		k0         += 0x9E37'79B9;
+		k1         += 0xBB67'AE85;
+	}
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = c3;
+}
+
+inline float UniformFloat(uint32_t bits, float min, float max)
+{
+	return min + static_cast<float>(bits >> 8) * (1.0f / 16777216.0f) * (max - min);
+}
+
+// Four uniform [0, 1) floats for one (seed, neuron, dendrite, step) key, identical on every thread.
+inline void RandomUniform(uint64_t seed, uint32_t neuron, uint32_t dendrite, uint64_t step, float (&out)[4])
+{
+	uint32_t counter[4] { neuron, dendrite, static_cast<uint32_t>(step), static_cast<uint32_t>(step >> 32) };
+	uint32_t bits[4];
+	Philox4x32(counter, seed, bits);
+	for (size_t i = 0; i < 4; ++i)
+		out[i] = UniformFloat(bits[i], 0.0f, 1.0f);
+}
+
+// Batched variant for dendrites [begin, end) of one neuron, runs on the selected SIMD kernel.
+void RandomUniformBatch(uint64_t seed, uint32_t neuron, uint64_t step, size_t begin, size_t end, float* u0, float* u1);
+
+uint64_t RandomSeedFromDevice();
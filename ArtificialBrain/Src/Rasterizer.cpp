@@ -0,0 +1,184 @@
+#include "Rasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Clamps in float before converting, casting a float outside the int range is undefined. NaN gives lo.
+static int ClampToInt(float value, int lo, int hi)
+{
+	if (!(value >= static_cast<float>(lo)))
+		return lo;
+	return value >= static_cast<float>(hi) ? hi : static_cast<int>(value);
+}
+
+LineRasterizer::LineRasterizer(uint32_t width, uint32_t height, uint32_t tileSize)
+	: m_Width(width),
+	  m_Height(height),
+	  m_TileSize(tileSize),
+	  m_TilesX((width + tileSize - 1) / tileSize),
+	  m_TilesY((height + tileSize - 1) / tileSize),
+	  m_Pixels(static_cast<size_t>(m_TilesX) * m_TilesY * tileSize * tileSize * 3),
+	  m_TileNeurons(static_cast<size_t>(m_TilesX) * m_TilesY)
+{
+}
+
+void LineRasterizer::Render(const std::vector<NeuronSoA>& neurons, Point camPos, Point camScale, ThreadPool& pool)
+{
+	// NDC x in [-1, 1] maps to [0, width), NDC y is flipped so the top row comes first.
+	m_Scale  = { 0.5f * m_Width * camScale.x, -0.5f * m_Height * camScale.y };
+	m_Offset = { 0.5f * m_Width * (1.0f - camPos.x * camScale.x), 0.5f * m_Height * (1.0f + camPos.y * camScale.y) };
+
+	m_Bounds.resize(neurons.size());
+	pool.ParallelFor(neurons.size(), 16, [&](size_t begin, size_t end, size_t) {
+		for (size_t n = begin; n < end; ++n)
+		{
+			const NeuronSoA& neuron = neurons[n];
+
+			float minX = std::numeric_limits<float>::max();
+			float minY = std::numeric_limits<float>::max();
+			float maxX = std::numeric_limits<float>::lowest();
+			float maxY = std::numeric_limits<float>::lowest();
+			for (size_t j = 0; j < neuron.Points(); ++j)
+			{
+				const float* x = neuron.X(j);
+				const float* y = neuron.Y(j);
+				for (size_t i = 0; i < neuron.Dendrites(); ++i)
+				{
+					minX = std::min(minX, x[i]);
+					maxX = std::max(maxX, x[i]);
+					minY = std::min(minY, y[i]);
+					maxY = std::max(maxY, y[i]);
+				}
+			}
+
+			Point a     = (neuron.pos + Point { minX, minY }) * m_Scale + m_Offset;
+			Point b     = (neuron.pos + Point { maxX, maxY }) * m_Scale + m_Offset;
+			m_Bounds[n] = { std::min(a.x, b.x) - 1.0f, std::min(a.y, b.y) - 1.0f, std::max(a.x, b.x) + 1.0f, std::max(a.y, b.y) + 1.0f };
+		}
+	});
+
+	for (auto& tileNeurons : m_TileNeurons)
+		tileNeurons.clear();
+	for (size_t n = 0; n < neurons.size(); ++n)
+	{
+		// Negated so bounds with a NaN are skipped as well.
+		const Bounds& bounds = m_Bounds[n];
+		if (!(bounds.maxX >= 0.0f && bounds.maxY >= 0.0f && bounds.minX < m_Width && bounds.minY < m_Height))
+			continue;
+
+		const int lastX = static_cast<int>(m_Width) - 1;
+		const int lastY = static_cast<int>(m_Height) - 1;
+		uint32_t  x0    = static_cast<uint32_t>(ClampToInt(bounds.minX, 0, lastX)) / m_TileSize;
+		uint32_t  y0    = static_cast<uint32_t>(ClampToInt(bounds.minY, 0, lastY)) / m_TileSize;
+		uint32_t  x1    = static_cast<uint32_t>(ClampToInt(bounds.maxX, 0, lastX)) / m_TileSize;
+		uint32_t  y1    = static_cast<uint32_t>(ClampToInt(bounds.maxY, 0, lastY)) / m_TileSize;
+		for (uint32_t y = y0; y <= y1; ++y)
+		{
+			for (uint32_t x = x0; x <= x1; ++x)
+				m_TileNeurons[y * m_TilesX + x].push_back(static_cast<uint32_t>(n));
+		}
+	}
+
+	pool.ParallelFor(m_TileNeurons.size(), 1, [&](size_t begin, size_t end, size_t) {
+		for (size_t tile = begin; tile < end; ++tile)
+			RasterizeTile(tile, neurons);
+	});
+}
+
+void LineRasterizer::Resolve(std::vector<uint8_t>& rgb) const
+{
+	rgb.resize(static_cast<size_t>(m_Width) * m_Height * 3);
+	for (uint32_t y = 0; y < m_Height; ++y)
+	{
+		uint32_t tileY  = y / m_TileSize;
+		uint32_t localY = y % m_TileSize;
+		for (uint32_t x = 0; x < m_Width; ++x)
+		{
+			size_t       tile  = static_cast<size_t>(tileY) * m_TilesX + x / m_TileSize;
+			const float* pixel = m_Pixels.data() + ((tile * m_TileSize + localY) * m_TileSize + x % m_TileSize) * 3;
+			uint8_t*     dst   = rgb.data() + (static_cast<size_t>(y) * m_Width + x) * 3;
+			for (size_t c = 0; c < 3; ++c)
+				dst[c] = static_cast<uint8_t>(std::min(pixel[c], 1.0f) * 255.0f + 0.5f);
+		}
+	}
+}
+
+void LineRasterizer::RasterizeTile(size_t tile, const std::vector<NeuronSoA>& neurons)
+{
+	float* pixels = m_Pixels.data() + tile * m_TileSize * m_TileSize * 3;
+	std::fill_n(pixels, m_TileSize * m_TileSize * 3, 0.0f);
+
+	int   tileX = static_cast<int>(tile % m_TilesX * m_TileSize);
+	int   tileY = static_cast<int>(tile / m_TilesX * m_TileSize);
+	float minX  = static_cast<float>(tileX) - 1.0f;
+	float minY  = static_cast<float>(tileY) - 1.0f;
+	float maxX  = static_cast<float>(tileX + m_TileSize) + 1.0f;
+	float maxY  = static_cast<float>(tileY + m_TileSize) + 1.0f;
+
+	// Same colors as the vertex shaders.
+	constexpr Color c_Longest  = { 1.00f, 0.05f, 0.05f };
+	constexpr Color c_Furthest = { 0.05f, 1.00f, 0.05f };
+	constexpr Color c_Other    = { 0.05f, 0.05f, 1.00f };
+
+	for (uint32_t n : m_TileNeurons[tile])
+	{
+		const NeuronSoA& neuron = neurons[n];
+		Point            origin = neuron.pos * m_Scale + m_Offset;
+		for (size_t i = 0; i < neuron.Dendrites(); ++i)
+		{
+			Color color = i == neuron.longest ? c_Longest : i == neuron.furthest ? c_Furthest : c_Other;
+			Point p0    = origin + Point { neuron.X(0)[i], neuron.Y(0)[i] } * m_Scale;
+			for (size_t j = 1; j < neuron.Points(); ++j)
+			{
+				Point p1 = origin + Point { neuron.X(j)[i], neuron.Y(j)[i] } * m_Scale;
+				if (std::max(p0.x, p1.x) >= minX && std::min(p0.x, p1.x) <= maxX && std::max(p0.y, p1.y) >= minY && std::min(p0.y, p1.y) <= maxY && (p0.x != p1.x || p0.y != p1.y))
+					DrawSegment(pixels, tileX, tileY, p0, p1, color);
+				p0 = p1;
+			}
+		}
+	}
+}
+
+void LineRasterizer::DrawSegment(float* pixels, int tileX, int tileY, Point p0, Point p1, Color color) const
+{
+	// Coverage falls off linearly with the distance from the pixel center to the segment, giving a
+	// line about one pixel wide. Each row only visits the x span where the segment is within reach.
+	int   size     = static_cast<int>(m_TileSize);
+	Point d        = p1 - p0;
+	float invLenSq = 1.0f / (d.x * d.x + d.y * d.y);
+
+	// One end of a segment crossing the tile can lie far outside of the int range.
+	int y0 = ClampToInt(std::floor(std::min(p0.y, p1.y) - 1.0f), tileY, tileY + size - 1);
+	int y1 = ClampToInt(std::ceil(std::max(p0.y, p1.y) + 1.0f), tileY, tileY + size - 1);
+	for (int y = y0; y <= y1; ++y)
+	{
+		float cy   = y + 0.5f;
+		float xMin = std::min(p0.x, p1.x);
+		float xMax = std::max(p0.x, p1.x);
+		if (std::fabs(d.y) > 1e-6f)
+		{
+			float t0 = std::clamp((cy - 1.0f - p0.y) / d.y, 0.0f, 1.0f);
+			float t1 = std::clamp((cy + 1.0f - p0.y) / d.y, 0.0f, 1.0f);
+			xMin     = std::min(p0.x + d.x * t0, p0.x + d.x * t1);
+			xMax     = std::max(p0.x + d.x * t0, p0.x + d.x * t1);
+		}
+
+		int x0 = ClampToInt(std::floor(xMin - 1.0f), tileX, tileX + size - 1);
+		int x1 = ClampToInt(std::ceil(xMax + 1.0f), tileX, tileX + size - 1);
+		for (int x = x0; x <= x1; ++x)
+		{
+			Point c        = { x + 0.5f - p0.x, cy - p0.y };
+			float t        = std::clamp((c.x * d.x + c.y * d.y) * invLenSq, 0.0f, 1.0f);
+			Point r        = c - d * t;
+			float coverage = 1.0f - std::sqrt(r.x * r.x + r.y * r.y);
+			if (coverage <= 0.0f)
+				continue;
+
+			float* pixel = pixels + ((y - tileY) * size + (x - tileX)) * 3;
+			pixel[0]     = std::max(pixel[0], color.r * coverage);
+			pixel[1]     = std::max(pixel[1], color.g * coverage);
+			pixel[2]     = std::max(pixel[2], color.b * coverage);
+		}
+	}
+}
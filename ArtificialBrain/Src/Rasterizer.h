@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Brain.h"
+#include "ThreadPool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+// CPU alternative to the GL renderer for hosts without a GPU. Draws every dendrite polyline as a
+// one pixel wide anti-aliased line with the camera transform and colors of the vertex shaders.
+// The framebuffer is stored as square tiles which are rasterized in parallel, each tile visits
+// only the neurons whose bounds overlap it. Overlapping lines combine with a per channel max so
+// the image does not depend on the thread count.
+class LineRasterizer
+{
+public:
+	LineRasterizer(uint32_t width, uint32_t height, uint32_t tileSize = 64);
+
+	uint32_t Width() const { return m_Width; }
+	uint32_t Height() const { return m_Height; }
+
+	// Clears the framebuffer and draws the neurons, pixel = (pos - camPos) * camScale mapped from NDC.
+	void Render(const std::vector<NeuronSoA>& neurons, Point camPos, Point camScale, ThreadPool& pool);
+	// Tightly packed RGB rows, top row first, same layout as OffscreenTarget::Read.
+	void Resolve(std::vector<uint8_t>& rgb) const;
+
+private:
+	struct Bounds
+	{
+		float minX, minY, maxX, maxY;
+	};
+
+	struct Color
+	{
+		float r, g, b;
+	};
+
+	void RasterizeTile(size_t tile, const std::vector<NeuronSoA>& neurons);
+	void DrawSegment(float* pixels, int tileX, int tileY, Point p0, Point p1, Color color) const;
+
+	uint32_t m_Width;
+	uint32_t m_Height;
+	uint32_t m_TileSize;
+	uint32_t m_TilesX;
+	uint32_t m_TilesY;
+
+	// Maps world space to pixel space, pixel = world * m_Scale + m_Offset.
+	Point m_Scale {};
+	Point m_Offset {};
+
+	std::vector<float>                 m_Pixels; // Tile major, 3 floats per pixel.
+	std::vector<Bounds>                m_Bounds;
+	std::vector<std::vector<uint32_t>> m_TileNeurons;
+};
@@ -0,0 +1,304 @@
+#include "Renderer.h"
+#include "Vertices.h"
+
+#include <cstdio>
+
+#include <string>
+
+const char s_VertexShaderSource[]        = R"glsl(#version 460 core
+
+layout(location = 0) in vec2 pos;
+
+layout(location = 0) out vec3 passCol;
+
+layout(location = 0) uniform vec2 camPos;
+layout(location = 1) uniform vec2 camScale;
+layout(location = 2) uniform uint verticesPerDendrite;
+layout(location = 3) uniform uint dendritesPerNeuron;
+layout(location = 5) uniform int firstVertex;
+
+struct Neuron
+{
+	vec2 pos;
+	uint longest;
+	uint furthest;
+};
+
+layout(std430, binding = 0) readonly buffer Neurons
+{
+	Neuron neurons[];
+};
+
+void main()
+{
+	uint dendrite = uint(gl_VertexID - firstVertex) / verticesPerDendrite;
+	uint neuron   = dendrite / dendritesPerNeuron;
+	uint index    = dendrite - neuron * dendritesPerNeuron;
+	gl_Position   = vec4((pos - camPos) * camScale, 0.0f, 1.0f);
+	passCol       = index == neurons[neuron].longest ? vec3(1.00f, 0.05f, 0.05f) : index == neurons[neuron].furthest ? vec3(0.05f, 1.00f, 0.05f) : vec3(0.05f, 0.05f, 1.00f);
+}
+)glsl";
+const char s_CompactVertexShaderSource[] = R"glsl(#version 460 core
+
+layout(location = 0) in vec2 pos;
+
+layout(location = 0) out vec3 passCol;
+
+layout(location = 0) uniform vec2 camPos;
+layout(location = 1) uniform vec2 camScale;
+layout(location = 2) uniform uint verticesPerDendrite;
+layout(location = 3) uniform uint dendritesPerNeuron;
+layout(location = 4) uniform float positionScale;
+
+struct Neuron
+{
+	vec2 pos;
+	uint longest;
+	uint furthest;
+};
+
+layout(std430, binding = 0) readonly buffer Neurons
+{
+	Neuron neurons[];
+};
+
+void main()
+{
+	uint dendrite = uint(gl_VertexID - gl_BaseVertex) / verticesPerDendrite;
+	uint neuron   = dendrite / dendritesPerNeuron;
+	uint index    = dendrite - neuron * dendritesPerNeuron;
+	gl_Position   = vec4((neurons[neuron].pos + pos * positionScale - camPos) * camScale, 0.0f, 1.0f);
+	passCol       = index == neurons[neuron].longest ? vec3(1.00f, 0.05f, 0.05f) : index == neurons[neuron].furthest ? vec3(0.05f, 1.00f, 0.05f) : vec3(0.05f, 0.05f, 1.00f);
+}
+)glsl";
+const char s_FragmentShaderSource[]      = R"glsl(#version 460 core
+
+layout(location = 0) in vec3 passCol;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+	outColor = vec4(passCol, 1.0f);
+}
+)glsl";
+
+Renderer::Renderer(RenderMode mode, size_t neuronCount, NeuronShape shape)
+	: m_Mode(mode),
+	  m_Shape(shape),
+	  m_Layout(ComputeFrameLayout(mode, neuronCount, shape))
+{
+	bool compact = m_Mode == RenderMode::Compact;
+	m_Program    = CompileProgram(compact ? s_CompactVertexShaderSource : s_VertexShaderSource, s_FragmentShaderSource);
+	if (!m_Program)
+		return;
+
+	m_Stream = std::make_unique<StreamBuffer>(m_Layout.size);
+
+	glCreateVertexArrays(1, &m_Vao);
+	glBindVertexArray(m_Vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_Stream->Buffer());
+	if (compact)
+	{
+		std::vector<uint32_t> indices = BuildLineStripIndices(shape.dendrites * neuronCount, shape.points);
+		glCreateBuffers(1, &m_Ibo);
+		glNamedBufferStorage(m_Ibo, indices.size() * sizeof(uint32_t), indices.data(), 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Ibo);
+		glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, sizeof(CompactVertex), 0);
+		glEnableVertexAttribArray(0);
+	}
+	else
+	{
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), 0);
+		glEnableVertexAttribArray(0);
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+}
+
+Renderer::~Renderer()
+{
+	m_Stream.reset();
+	if (m_Ibo)
+		glDeleteBuffers(1, &m_Ibo);
+	if (m_Vao)
+		glDeleteVertexArrays(1, &m_Vao);
+	if (m_Program)
+		glDeleteProgram(m_Program);
+}
+
+size_t Renderer::Upload(const std::vector<NeuronSoA>& neurons)
+{
+	char* region = static_cast<char*>(m_Stream->Next());
+	if (m_Mode == RenderMode::Compact)
+	{
+		m_Count = BuildCompactVertices(neurons, reinterpret_cast<CompactVertex*>(region + m_Layout.vertices));
+		BuildRenderNeurons(neurons, reinterpret_cast<RenderNeuron*>(region + m_Layout.neurons));
+		return m_Count / m_Shape.points * (m_Shape.points - 1);
+	}
+
+	m_Count = BuildLineSegments(neurons, reinterpret_cast<Vertex*>(region + m_Layout.vertices));
+	BuildRenderNeurons(neurons, reinterpret_cast<RenderNeuron*>(region + m_Layout.neurons));
+	return m_Count / 2;
+}
+
+void Renderer::Draw(float camX, float camY, float scaleX, float scaleY)
+{
+	glUseProgram(m_Program);
+	glUniform2f(0, camX, camY);
+	glUniform2f(1, scaleX, scaleY);
+
+	glBindVertexArray(m_Vao);
+	size_t offset = m_Stream->Offset();
+	glUniform1ui(3, static_cast<GLuint>(m_Shape.dendrites));
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, m_Stream->Buffer(), offset + m_Layout.neurons, m_Layout.size - m_Layout.neurons);
+	if (m_Mode == RenderMode::Compact)
+	{
+		glUniform1ui(2, static_cast<GLuint>(m_Shape.points));
+		glUniform1f(4, 1.0f / c_CompactPositionScale);
+		size_t dendrites = m_Count / m_Shape.points;
+		glDrawElementsBaseVertex(GL_LINE_STRIP, static_cast<GLsizei>(dendrites * (m_Shape.points + 1)), GL_UNSIGNED_INT, nullptr, static_cast<GLint>((offset + m_Layout.vertices) / sizeof(CompactVertex)));
+	}
+	else
+	{
+		GLint firstVertex = static_cast<GLint>((offset + m_Layout.vertices) / sizeof(Vertex));
+		glUniform1ui(2, static_cast<GLuint>(2 * (m_Shape.points - 1)));
+		glUniform1i(5, firstVertex);
+		glDrawArrays(GL_LINES, firstVertex, static_cast<GLsizei>(m_Count));
+	}
+	m_Stream->Fence();
+
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+OffscreenTarget::OffscreenTarget(uint32_t width, uint32_t height)
+	: m_Width(width),
+	  m_Height(height),
+	  m_Pixels(static_cast<size_t>(width) * height * 4)
+{
+	glCreateRenderbuffers(1, &m_Renderbuffer);
+	glNamedRenderbufferStorage(m_Renderbuffer, GL_RGBA8, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+	glCreateFramebuffers(1, &m_Framebuffer);
+	glNamedFramebufferRenderbuffer(m_Framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_Renderbuffer);
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+	glDeleteFramebuffers(1, &m_Framebuffer);
+	glDeleteRenderbuffers(1, &m_Renderbuffer);
+}
+
+void OffscreenTarget::Bind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+	glViewport(0, 0, static_cast<GLsizei>(m_Width), static_cast<GLsizei>(m_Height));
+}
+
+void OffscreenTarget::Read(std::vector<uint8_t>& rgb)
+{
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glNamedFramebufferReadBuffer(m_Framebuffer, GL_COLOR_ATTACHMENT0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_Framebuffer);
+	glReadPixels(0, 0, static_cast<GLsizei>(m_Width), static_cast<GLsizei>(m_Height), GL_RGBA, GL_UNSIGNED_BYTE, m_Pixels.data());
+
+	// GL rows start at the bottom.
+	rgb.resize(static_cast<size_t>(m_Width) * m_Height * 3);
+	for (uint32_t y = 0; y < m_Height; ++y)
+	{
+		const uint8_t* src = m_Pixels.data() + static_cast<size_t>(m_Height - 1 - y) * m_Width * 4;
+		uint8_t*       dst = rgb.data() + static_cast<size_t>(y) * m_Width * 3;
+		for (uint32_t x = 0; x < m_Width; ++x)
+		{
+			dst[x * 3 + 0] = src[x * 4 + 0];
+			dst[x * 3 + 1] = src[x * 4 + 1];
+			dst[x * 3 + 2] = src[x * 4 + 2];
+		}
+	}
+}
+
+FrameLayout ComputeFrameLayout(RenderMode mode, size_t neuronCount, NeuronShape shape)
+{
+	// Shader storage bindings need offsets aligned to GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, at most 256.
+	auto align = [](size_t size) { return (size + 255) / 256 * 256; };
+
+	size_t vertexBytes = mode == RenderMode::Compact ? CompactVerticesPerNeuron(shape) * sizeof(CompactVertex) : LineVerticesPerNeuron(shape) * sizeof(Vertex);
+
+	FrameLayout layout;
+	layout.vertices = 0;
+	layout.neurons  = align(vertexBytes * neuronCount);
+	layout.size     = layout.neurons + align(neuronCount * sizeof(RenderNeuron));
+	return layout;
+}
+
+GLuint CompileProgram(const char* vertexShaderSource, const char* fragmentShaderSource)
+{
+	GLuint vertexShader   = glCreateShader(GL_VERTEX_SHADER);
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+
+	const char* sources[] { vertexShaderSource };
+	glShaderSource(vertexShader, 1, sources, nullptr);
+	sources[0] = fragmentShaderSource;
+	glShaderSource(fragmentShader, 1, sources, nullptr);
+	glCompileShader(vertexShader);
+	glCompileShader(fragmentShader);
+
+	{
+		bool failed = false;
+
+		int status = 0;
+		glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &status);
+		if (!status)
+		{
+			int length = 0;
+			glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &length);
+			std::string log(length, '\0');
+			glGetShaderInfoLog(vertexShader, length, nullptr, log.data());
+			std::printf("VertexShader log: %s\n", log.c_str());
+			failed = true;
+		}
+
+		glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &status);
+		if (!status)
+		{
+			int length = 0;
+			glGetShaderiv(fragmentShader, GL_INFO_LOG_LENGTH, &length);
+			std::string log(length, '\0');
+			glGetShaderInfoLog(fragmentShader, length, nullptr, log.data());
+			std::printf("FragmentShader log: %s\n", log.c_str());
+			failed = true;
+		}
+
+		if (failed)
+		{
+			glDeleteShader(vertexShader);
+			glDeleteShader(fragmentShader);
+			return 0;
+		}
+	}
+
+	GLuint program = glCreateProgram();
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDetachShader(program, vertexShader);
+	glDetachShader(program, fragmentShader);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+	int status = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (!status)
+	{
+		int length = 0;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+		std::string log(length, '\0');
+		glGetProgramInfoLog(program, length, nullptr, log.data());
+		std::printf("Linkage log: %s\n", log.data());
+		glDeleteProgram(program);
+		return 0;
+	}
+
+	return program;
+}
\ No newline at end of file
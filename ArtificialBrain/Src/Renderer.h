@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Brain.h"
+#include "StreamBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+
+enum class RenderMode
+{
+	Lines,
+	Compact
+};
+
+// Byte offsets of the per frame data within one StreamBuffer region.
+struct FrameLayout
+{
+	size_t vertices;
+	size_t neurons;
+	size_t size;
+};
+
+FrameLayout ComputeFrameLayout(RenderMode mode, size_t neuronCount, NeuronShape shape);
+GLuint      CompileProgram(const char* vertexShaderSource, const char* fragmentShaderSource);
+
+// Draws a population with the lines or compact shaders, used by both the window and the offscreen
+// recorder. Needs a current GL 4.6 context for its whole lifetime.
+class Renderer
+{
+public:
+	Renderer(RenderMode mode, size_t neuronCount, NeuronShape shape);
+	~Renderer();
+
+	Renderer(const Renderer&)            = delete;
+	Renderer& operator=(const Renderer&) = delete;
+
+	bool Valid() const { return m_Program != 0; }
+
+	// Writes the next stream region from the neurons, returns the segment count.
+	size_t Upload(const std::vector<NeuronSoA>& neurons);
+	// Draws the last uploaded region into the current framebuffer.
+	void Draw(float camX, float camY, float scaleX, float scaleY);
+
+private:
+	RenderMode                    m_Mode;
+	NeuronShape                   m_Shape;
+	FrameLayout                   m_Layout;
+	std::unique_ptr<StreamBuffer> m_Stream;
+	GLuint                        m_Program = 0;
+	GLuint                        m_Vao     = 0;
+	GLuint                        m_Ibo     = 0;
+	size_t                        m_Count   = 0;
+};
+
+// RGBA8 color renderbuffer for rendering without a visible window.
+class OffscreenTarget
+{
+public:
+	OffscreenTarget(uint32_t width, uint32_t height);
+	~OffscreenTarget();
+
+	OffscreenTarget(const OffscreenTarget&)            = delete;
+	OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+	uint32_t Width() const { return m_Width; }
+	uint32_t Height() const { return m_Height; }
+
+	void Bind();
+	// Reads back the color attachment as tightly packed RGB rows, top row first.
+	void Read(std::vector<uint8_t>& rgb);
+
+private:
+	uint32_t             m_Width;
+	uint32_t             m_Height;
+	GLuint               m_Framebuffer  = 0;
+	GLuint               m_Renderbuffer = 0;
+	std::vector<uint8_t> m_Pixels;
+};
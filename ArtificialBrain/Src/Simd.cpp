@@ -0,0 +1,86 @@
+#include "Simd.h"
+
+#include <cstring>
+
+#include <initializer_list>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+const char* SimdKernelName(SimdKernel kernel)
+{
+	switch (kernel)
+	{
+	case SimdKernel::Scalar: return "scalar";
+	case SimdKernel::SSE41: return "sse4.1";
+	case SimdKernel::AVX2: return "avx2";
+	case SimdKernel::AVX512: return "avx512";
+	}
+	return "unknown";
+}
+
+bool ParseSimdKernel(const char* name, SimdKernel& kernel)
+{
+	for (SimdKernel candidate : { SimdKernel::Scalar, SimdKernel::SSE41, SimdKernel::AVX2, SimdKernel::AVX512 })
+	{
+		if (std::strcmp(name, SimdKernelName(candidate)) == 0)
+		{
+			kernel = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool IsSimdKernelSupported(SimdKernel kernel)
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool sse41   = (info[2] & (1 << 19)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	auto xcr0    = osxsave ? _xgetbv(0) : 0;
+	__cpuidex(info, 7, 0);
+	// /arch:AVX512 lets MSVC emit F, CD, BW, DQ and VL instructions, so all of them are required.
+	const unsigned avx512Bits = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+	bool           avx2       = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x06) == 0x06;
+	bool           avx512     = (static_cast<unsigned>(info[1]) & avx512Bits) == avx512Bits && (xcr0 & 0xE6) == 0xE6;
+#else
+	__builtin_cpu_init();
+	bool sse41  = __builtin_cpu_supports("sse4.1");
+	bool avx2   = __builtin_cpu_supports("avx2");
+	bool avx512 = __builtin_cpu_supports("avx512f"); // The kernel unit is built with -mavx512f only.
+#endif
+
+	switch (kernel)
+	{
+	case SimdKernel::Scalar: return true;
+	case SimdKernel::SSE41: return sse41;
+	case SimdKernel::AVX2: return avx2;
+	case SimdKernel::AVX512: return avx512;
+	}
+	return false;
+}
+
+SimdKernel BestSimdKernel()
+{
+	for (SimdKernel kernel : { SimdKernel::AVX512, SimdKernel::AVX2, SimdKernel::SSE41 })
+	{
+		if (IsSimdKernelSupported(kernel))
+			return kernel;
+	}
+	return SimdKernel::Scalar;
+}
+
+static SimdKernel s_SimdKernel = BestSimdKernel();
+
+void SetSimdKernel(SimdKernel kernel)
+{
+	s_SimdKernel = IsSimdKernelSupported(kernel) ? kernel : SimdKernel::Scalar;
+}
+
+SimdKernel GetSimdKernel()
+{
+	return s_SimdKernel;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Instruction sets the kernels are built for, each has its own translation unit compiled with the
+// matching flags and is only called once the CPU is known to support it.
+enum class SimdKernel
+{
+	Scalar,
+	SSE41,
+	AVX2,
+	AVX512
+};
+
+const char* SimdKernelName(SimdKernel kernel);
+bool        ParseSimdKernel(const char* name, SimdKernel& kernel);
+bool        IsSimdKernelSupported(SimdKernel kernel);
+SimdKernel  BestSimdKernel();
+
+// Instruction set of the kernels that do not grow neurites, PropagateRows and the cable solver.
+// Kept apart from SetGrowKernel so a growth kernel rejected by VerifyGrowKernel leaves them be.
+void       SetSimdKernel(SimdKernel kernel);
+SimdKernel GetSimdKernel();
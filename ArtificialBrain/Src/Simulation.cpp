@@ -0,0 +1,82 @@
+#include "Simulation.h"
+
+#include <algorithm>
+#include <chrono>
+
+Simulation::Simulation(NeuronPopulation& population, ThreadPool& pool, double stepsPerSecond)
+	: m_Population(population),
+	  m_Pool(pool),
+	  m_StepsPerSecond(stepsPerSecond)
+{
+	m_Thread = std::thread(&Simulation::Run, this);
+}
+
+Simulation::~Simulation()
+{
+	m_Stop.store(true, std::memory_order_relaxed);
+	m_Thread.join();
+}
+
+const PopulationSnapshot* Simulation::Latest()
+{
+	m_HasSnapshot |= m_Snapshots.Update();
+	return m_HasSnapshot ? &m_Snapshots.Front() : nullptr;
+}
+
+// Every GrowNeuron advances the neuron's step, so a copy whose step matches is still current. Each
+// snapshot buffer keeps the neurons it received, only the ones grown since are copied again.
+static void CopyChangedNeurons(std::vector<NeuronSoA>& copy, const std::vector<NeuronSoA>& neurons)
+{
+	if (copy.size() != neurons.size())
+	{
+		copy = neurons;
+		return;
+	}
+	for (size_t n = 0; n < neurons.size(); ++n)
+		if (copy[n].step != neurons[n].step)
+			copy[n] = neurons[n];
+}
+
+void Simulation::Run()
+{
+	using Clock = std::chrono::steady_clock;
+
+	auto     interval      = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_StepsPerSecond > 0.0 ? 1.0 / m_StepsPerSecond : 0.0));
+	auto     nextStep      = Clock::now();
+	auto     statsTime     = nextStep;
+	uint64_t step          = 0;
+	size_t   statsSteps    = 0;
+	size_t   statsSegments = 0;
+	double   stepsRate     = 0.0;
+	double   segmentsRate  = 0.0;
+	while (!m_Stop.load(std::memory_order_relaxed))
+	{
+		if (m_StepsPerSecond > 0.0)
+		{
+			std::this_thread::sleep_until(nextStep);
+			nextStep = std::max(nextStep + interval, Clock::now() - 4 * interval);
+		}
+
+		statsSegments += GrowPopulation(m_Population, m_Pool);
+		++statsSteps;
+		++step;
+
+		auto   time    = Clock::now();
+		double elapsed = std::chrono::duration<double>(time - statsTime).count();
+		if (elapsed >= 1.0)
+		{
+			stepsRate     = statsSteps / elapsed;
+			segmentsRate  = statsSegments / elapsed;
+			statsTime     = time;
+			statsSteps    = 0;
+			statsSegments = 0;
+		}
+
+		PopulationSnapshot& snapshot = m_Snapshots.Back();
+		CopyChangedNeurons(snapshot.neurons, m_Population.neurons);
+		snapshot.step              = step;
+		snapshot.stepsPerSecond    = stepsRate;
+		snapshot.segmentsPerSecond = segmentsRate;
+		m_Snapshots.Publish();
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Brain.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <thread>
+
+struct PopulationSnapshot
+{
+	std::vector<NeuronSoA> neurons;
+
+	uint64_t step              = 0;
+	double   stepsPerSecond    = 0.0;
+	double   segmentsPerSecond = 0.0;
+};
+
+class Simulation
+{
+public:
+	// stepsPerSecond <= 0 runs unthrottled.
+	Simulation(NeuronPopulation& population, ThreadPool& pool, double stepsPerSecond);
+	~Simulation();
+
+	Simulation(const Simulation&)            = delete;
+	Simulation& operator=(const Simulation&) = delete;
+
+	// Render thread side, returns the latest published snapshot or nullptr before the first one.
+	const PopulationSnapshot* Latest();
+
+private:
+	void Run();
+
+	NeuronPopulation& m_Population;
+	ThreadPool&       m_Pool;
+	double            m_StepsPerSecond;
+
+	TripleBuffer<PopulationSnapshot> m_Snapshots;
+	bool                             m_HasSnapshot = false;
+
+	std::atomic<bool> m_Stop { false };
+	std::thread       m_Thread;
+};
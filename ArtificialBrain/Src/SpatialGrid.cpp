@@ -0,0 +1,248 @@
+#include "SpatialGrid.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Neuron ranges counted and scattered independently, each needs its own histogram.
+constexpr size_t c_GridMaxRanges = 8;
+
+SpatialGrid::SpatialGrid(float cellSize)
+	: m_RequestedCellSize(cellSize)
+{
+}
+
+size_t SpatialGrid::CellOf(Point pos) const
+{
+	size_t x = std::min(static_cast<size_t>(std::max((pos.x - m_Origin.x) * m_InvCellSize, 0.0f)), m_CellsX - 1);
+	size_t y = std::min(static_cast<size_t>(std::max((pos.y - m_Origin.y) * m_InvCellSize, 0.0f)), m_CellsY - 1);
+	return y * m_CellsX + x;
+}
+
+bool IsGridShapeSupported(NeuronShape shape, size_t neurons)
+{
+	if (shape.dendrites > c_GridMaxDendrites || shape.points > c_GridMaxPoints)
+		return false;
+	return neurons == 0 || static_cast<uint64_t>(shape.dendrites) * shape.points <= c_GridMaxTotal / neurons;
+}
+
+bool SpatialGrid::Build(const std::vector<NeuronSoA>& neurons, ThreadPool& pool)
+{
+	return Build(neurons, nullptr, neurons.size(), pool);
+}
+
+bool SpatialGrid::Build(const std::vector<NeuronSoA>& neurons, const std::vector<uint32_t>& indices, ThreadPool& pool)
+{
+	return Build(neurons, indices.data(), indices.size(), pool);
+}
+
+bool SpatialGrid::Build(const std::vector<NeuronSoA>& neurons, const uint32_t* indices, size_t count, ThreadPool& pool)
+{
+	if (count != 0 && !IsGridShapeSupported(neurons[0].Shape(), count))
+	{
+		m_Points.clear();
+		m_CellsX = m_CellsY = 1;
+		m_CellStart.assign(2, 0);
+		return false;
+	}
+
+	struct alignas(64) Partial
+	{
+		Point  min { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+		Point  max { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+		size_t points = 0;
+	};
+
+	auto neuronAt = [&](size_t k) { return indices ? indices[k] : k; };
+
+	std::vector<Partial> partials(pool.ThreadCount());
+	pool.ParallelFor(count, 64, [&](size_t begin, size_t end, size_t thread) {
+		Partial& partial = partials[thread];
+		for (size_t k = begin; k < end; ++k)
+		{
+			const NeuronSoA& neuron = neurons[neuronAt(k)];
+			for (size_t j = 0; j < neuron.Points(); ++j)
+			{
+				const float* x = neuron.X(j);
+				const float* y = neuron.Y(j);
+				for (size_t i = 0; i < neuron.Dendrites(); ++i)
+				{
+					partial.min.x = std::min(partial.min.x, neuron.pos.x + x[i]);
+					partial.min.y = std::min(partial.min.y, neuron.pos.y + y[i]);
+					partial.max.x = std::max(partial.max.x, neuron.pos.x + x[i]);
+					partial.max.y = std::max(partial.max.y, neuron.pos.y + y[i]);
+				}
+			}
+			partial.points += neuron.Dendrites() * neuron.Points();
+		}
+	});
+
+	Partial total;
+	for (auto& partial : partials)
+	{
+		total.min     = { std::min(total.min.x, partial.min.x), std::min(total.min.y, partial.min.y) };
+		total.max     = { std::max(total.max.x, partial.max.x), std::max(total.max.y, partial.max.y) };
+		total.points += partial.points;
+	}
+
+	m_Points.resize(total.points);
+	if (total.points == 0)
+	{
+		m_CellsX = m_CellsY = 1;
+		m_CellStart.assign(2, 0);
+		return true;
+	}
+
+	// Grow the cells until there are at most as many cells as points.
+	Point extent = total.max - total.min;
+	m_CellSize   = std::max(m_RequestedCellSize, 1e-6f);
+	while ((std::floor(extent.x / m_CellSize) + 1.0f) * (std::floor(extent.y / m_CellSize) + 1.0f) > static_cast<float>(total.points))
+		m_CellSize *= 2.0f;
+	m_InvCellSize = 1.0f / m_CellSize;
+	m_Origin      = total.min;
+	m_CellsX      = static_cast<size_t>(extent.x * m_InvCellSize) + 1;
+	m_CellsY      = static_cast<size_t>(extent.y * m_InvCellSize) + 1;
+
+	const size_t cells      = m_CellsX * m_CellsY;
+	const size_t ranges     = std::min({ pool.ThreadCount(), c_GridMaxRanges, count });
+	auto         rangeBegin = [&](size_t range) { return count * range / ranges; };
+
+	m_Counts.assign(ranges * cells, 0);
+	pool.ParallelFor(ranges, 1, [&](size_t begin, size_t end, size_t) {
+		for (size_t range = begin; range < end; ++range)
+		{
+			uint32_t* counts = m_Counts.data() + range * cells;
+			for (size_t k = rangeBegin(range); k < rangeBegin(range + 1); ++k)
+			{
+				const NeuronSoA& neuron = neurons[neuronAt(k)];
+				for (size_t j = 0; j < neuron.Points(); ++j)
+				{
+					for (size_t i = 0; i < neuron.Dendrites(); ++i)
+						++counts[CellOf(neuron.pos + Point { neuron.X(j)[i], neuron.Y(j)[i] })];
+				}
+			}
+		}
+	});
+
+	// Exclusive prefix over (cell, range) so every range scatters into its own slice of each cell.
+	m_CellStart.resize(cells + 1);
+	uint32_t offset = 0;
+	for (size_t c = 0; c < cells; ++c)
+	{
+		m_CellStart[c] = offset;
+		for (size_t range = 0; range < ranges; ++range)
+		{
+			uint32_t count               = m_Counts[range * cells + c];
+			m_Counts[range * cells + c]  = offset;
+			offset                      += count;
+		}
+	}
+	m_CellStart[cells] = offset;
+
+	pool.ParallelFor(ranges, 1, [&](size_t begin, size_t end, size_t) {
+		for (size_t range = begin; range < end; ++range)
+		{
+			uint32_t* offsets = m_Counts.data() + range * cells;
+			for (size_t k = rangeBegin(range); k < rangeBegin(range + 1); ++k)
+			{
+				size_t           n      = neuronAt(k);
+				const NeuronSoA& neuron = neurons[n];
+				for (size_t j = 0; j < neuron.Points(); ++j)
+				{
+					for (size_t i = 0; i < neuron.Dendrites(); ++i)
+					{
+						Point pos                        = neuron.pos + Point { neuron.X(j)[i], neuron.Y(j)[i] };
+						m_Points[offsets[CellOf(pos)]++] = { pos, static_cast<uint32_t>(n), static_cast<uint32_t>(i), static_cast<uint32_t>(j) };
+					}
+				}
+			}
+		}
+	});
+	return true;
+}
+
+void SpatialGrid::QueryRadius(Point center, float radius, std::vector<GridPoint>& out, uint32_t excludeNeuron) const
+{
+	ForEachInRadius(center, radius, [&](const GridPoint& point, float) {
+		if (point.neuron != excludeNeuron)
+			out.push_back(point);
+	});
+}
+
+void SpatialGrid::QueryNearest(Point center, size_t k, std::vector<GridPoint>& out, uint32_t excludeNeuron) const
+{
+	out.clear();
+	if (m_Points.empty() || k == 0)
+		return;
+
+	struct Candidate
+	{
+		float     distSq;
+		GridPoint point;
+
+		bool operator<(const Candidate& other) const { return distSq < other.distSq; }
+	};
+
+	// Max heap of the k best so far, rings of cells around the center cell are visited outwards.
+	// Every cell of ring r + 1 is at least r cells away, which bounds when the search can stop.
+	std::vector<Candidate> heap;
+	heap.reserve(k + 1);
+
+	Point     cell   = (center - m_Origin) * m_InvCellSize;
+	ptrdiff_t cx     = static_cast<ptrdiff_t>(std::floor(cell.x));
+	ptrdiff_t cy     = static_cast<ptrdiff_t>(std::floor(cell.y));
+	ptrdiff_t width  = static_cast<ptrdiff_t>(m_CellsX);
+	ptrdiff_t height = static_cast<ptrdiff_t>(m_CellsY);
+	ptrdiff_t rings  = std::max({ cx, width - 1 - cx, cy, height - 1 - cy, ptrdiff_t { 0 } });
+
+	auto visitCell = [&](ptrdiff_t x, ptrdiff_t y) {
+		if (x < 0 || y < 0 || x >= width || y >= height)
+			return;
+		size_t c = static_cast<size_t>(y * width + x);
+		for (uint32_t p = m_CellStart[c]; p < m_CellStart[c + 1]; ++p)
+		{
+			const GridPoint& point  = m_Points[p];
+			Point            d      = point.pos - center;
+			float            distSq = d.x * d.x + d.y * d.y;
+			if (point.neuron == excludeNeuron || (heap.size() == k && distSq >= heap.front().distSq))
+				continue;
+			heap.push_back({ distSq, point });
+			std::push_heap(heap.begin(), heap.end());
+			if (heap.size() > k)
+			{
+				std::pop_heap(heap.begin(), heap.end());
+				heap.pop_back();
+			}
+		}
+	};
+
+	for (ptrdiff_t r = 0; r <= rings; ++r)
+	{
+		if (r == 0)
+		{
+			visitCell(cx, cy);
+		}
+		else
+		{
+			for (ptrdiff_t x = cx - r; x <= cx + r; ++x)
+			{
+				visitCell(x, cy - r);
+				visitCell(x, cy + r);
+			}
+			for (ptrdiff_t y = cy - r + 1; y < cy + r; ++y)
+			{
+				visitCell(cx - r, y);
+				visitCell(cx + r, y);
+			}
+		}
+
+		float reach = r * m_CellSize;
+		if (heap.size() == k && heap.front().distSq <= reach * reach)
+			break;
+	}
+
+	std::sort_heap(heap.begin(), heap.end());
+	out.reserve(heap.size());
+	for (auto& candidate : heap)
+		out.push_back(candidate.point);
+}
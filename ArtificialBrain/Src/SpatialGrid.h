@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Brain.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+class ThreadPool;
+
+constexpr uint32_t c_NoNeuron = std::numeric_limits<uint32_t>::max();
+
+// Limits of the GridPoint fields and of the 32 bit cell offsets.
+constexpr size_t   c_GridMaxDendrites = size_t(1) << 24;
+constexpr size_t   c_GridMaxPoints    = 256;
+constexpr uint64_t c_GridMaxTotal     = std::numeric_limits<uint32_t>::max();
+
+// Whether neurons of the given shape can be indexed, at most c_GridMaxTotal points in total.
+bool IsGridShapeSupported(NeuronShape shape, size_t neurons);
+
+// One indexed dendrite point in world space, supports up to 2^24 dendrites of 256 points.
+struct GridPoint
+{
+	Point    pos;
+	uint32_t neuron;
+	uint32_t dendrite : 24;
+	uint32_t point    : 8;
+};
+
+// Uniform grid over the dendrite points of a population for proximity queries. Growth moves all
+// points of an active dendrite, so the index is rebuilt from scratch: a counting sort of the
+// points into cells, split over contiguous neuron ranges so the order within a cell, and with it
+// every query result, does not depend on the thread count. A grid can index just some of the
+// neurons, which lets the points that no longer move stay in a grid of their own.
+class SpatialGrid
+{
+public:
+	// cellSize should be about the typical query radius, it is raised when the grid would have
+	// more cells than points.
+	explicit SpatialGrid(float cellSize);
+
+	// Returns false and leaves the grid empty when the neurons exceed IsGridShapeSupported.
+	bool Build(const std::vector<NeuronSoA>& neurons, ThreadPool& pool);
+	// Indexes only neurons[indices[k]], GridPoint::neuron still refers to neurons.
+	bool Build(const std::vector<NeuronSoA>& neurons, const std::vector<uint32_t>& indices, ThreadPool& pool);
+
+	size_t Size() const { return m_Points.size(); }
+	float  CellSize() const { return m_CellSize; }
+
+	// Appends the points within radius of center, skipping excludeNeuron.
+	void QueryRadius(Point center, float radius, std::vector<GridPoint>& out, uint32_t excludeNeuron = c_NoNeuron) const;
+	// Calls fn(point, distSq) for the points within radius of center in index order.
+	template <class Fn>
+	void ForEachInRadius(Point center, float radius, Fn&& fn) const;
+	// Replaces out with the k points closest to center ordered by distance, skipping excludeNeuron.
+	void QueryNearest(Point center, size_t k, std::vector<GridPoint>& out, uint32_t excludeNeuron = c_NoNeuron) const;
+
+private:
+	size_t CellOf(Point pos) const;
+	// Indexes neurons[indices[k]] for k below count, or the first count neurons without indices.
+	bool Build(const std::vector<NeuronSoA>& neurons, const uint32_t* indices, size_t count, ThreadPool& pool);
+
+	float m_RequestedCellSize;
+	float m_CellSize    = 1.0f;
+	float m_InvCellSize = 1.0f;
+	Point m_Origin {};
+
+	size_t m_CellsX = 0;
+	size_t m_CellsY = 0;
+
+	std::vector<uint32_t>  m_CellStart; // m_CellsX * m_CellsY + 1 offsets into m_Points.
+	std::vector<GridPoint> m_Points;
+	std::vector<uint32_t>  m_Counts; // Per neuron range cell histograms, kept to avoid reallocating.
+};
+
+template <class Fn>
+void SpatialGrid::ForEachInRadius(Point center, float radius, Fn&& fn) const
+{
+	if (m_Points.empty())
+		return;
+
+	float radiusSq = radius * radius;
+	Point lo       = (center - Point { radius, radius } - m_Origin) * m_InvCellSize;
+	Point hi       = (center + Point { radius, radius } - m_Origin) * m_InvCellSize;
+	if (hi.x < 0.0f || hi.y < 0.0f || lo.x >= m_CellsX || lo.y >= m_CellsY)
+		return;
+
+	size_t x0 = static_cast<size_t>(std::max(lo.x, 0.0f));
+	size_t y0 = static_cast<size_t>(std::max(lo.y, 0.0f));
+	size_t x1 = static_cast<size_t>(std::min(hi.x, static_cast<float>(m_CellsX - 1)));
+	size_t y1 = static_cast<size_t>(std::min(hi.y, static_cast<float>(m_CellsY - 1)));
+	for (size_t y = y0; y <= y1; ++y)
+	{
+		// Cells of a row are contiguous in m_Points.
+		const GridPoint* begin = m_Points.data() + m_CellStart[y * m_CellsX + x0];
+		const GridPoint* end   = m_Points.data() + m_CellStart[y * m_CellsX + x1 + 1];
+		for (const GridPoint* point = begin; point != end; ++point)
+		{
+			Point d      = point->pos - center;
+			float distSq = d.x * d.x + d.y * d.y;
+			if (distSq <= radiusSq)
+				fn(*point, distSq);
+		}
+	}
+}
@@ -0,0 +1,216 @@
+#include "Spiking.h"
+#include "SynapseMatrix.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+
+#include <algorithm>
+
+TimingWheel::TimingWheel(uint32_t now)
+	: m_Now(now)
+{
+}
+
+void TimingWheel::Insert(const SpikeEvent& event)
+{
+	// The level is the highest slot digit in which the event time differs from now.
+	uint32_t diff  = event.time ^ m_Now;
+	uint32_t level = 0;
+	while (level + 1 < c_Levels && diff >= (1u << (c_Bits * (level + 1))))
+		++level;
+	m_Slots[level][(event.time >> (c_Bits * level)) & (c_Slots - 1)].push_back(event);
+	++m_Size;
+}
+
+void TimingWheel::Advance(std::vector<SpikeEvent>& out)
+{
+	std::vector<SpikeEvent>& slot = m_Slots[0][m_Now & (c_Slots - 1)];
+	out.clear();
+	out.swap(slot);
+	m_Size -= out.size();
+
+	++m_Now;
+	for (uint32_t level = 1; level < c_Levels && (m_Now & ((1u << (c_Bits * level)) - 1)) == 0; ++level)
+		Cascade(level);
+}
+
+void TimingWheel::Drain(std::vector<SpikeEvent>& out)
+{
+	for (auto& level : m_Slots)
+	{
+		for (auto& slot : level)
+		{
+			out.insert(out.end(), slot.begin(), slot.end());
+			slot.clear();
+		}
+	}
+	m_Size = 0;
+}
+
+// Moves the slot of level that now became current down to the lower levels.
+void TimingWheel::Cascade(uint32_t level)
+{
+	std::vector<SpikeEvent>& slot = m_Slots[level][(m_Now >> (c_Bits * level)) & (c_Slots - 1)];
+	m_Scratch.clear();
+	m_Scratch.swap(slot);
+	m_Size -= m_Scratch.size();
+	for (const SpikeEvent& event : m_Scratch)
+		Insert(event);
+}
+
+SpikingNetwork::SpikingNetwork(SpikingParams params)
+	: m_Params(params),
+	  m_DecayTable(c_DecayTableSize)
+{
+	m_Params.minDelay = std::max(m_Params.minDelay, 1u);
+	for (size_t dt = 0; dt < c_DecayTableSize; ++dt)
+		m_DecayTable[dt] = std::pow(m_Params.decay, static_cast<float>(dt));
+}
+
+void SpikingNetwork::Resize(const std::vector<Point>& positions)
+{
+	size_t neurons = positions.size();
+	m_Positions    = positions;
+	m_Voltage.resize(neurons, m_Params.reset);
+	m_LastUpdate.resize(neurons, m_Now);
+	m_RefractoryEnd.resize(neurons, 0);
+
+	// Pending events are collected and handed to their owners under the new ranges.
+	std::vector<SpikeEvent> pending;
+	for (Partition& partition : m_Partitions)
+		partition.wheel.Drain(pending);
+
+	size_t partitions = std::clamp<size_t>(neurons / 1024, 1, c_SpikeMaxPartitions);
+	m_PartitionSize   = std::max<size_t>((neurons + partitions - 1) / partitions, 1);
+	m_Partitions.clear();
+	m_Partitions.resize(partitions);
+	for (Partition& partition : m_Partitions)
+	{
+		partition.wheel = TimingWheel(m_Now);
+		partition.outbox.resize(partitions);
+	}
+	for (const SpikeEvent& event : pending)
+		if (event.target < neurons)
+			m_Partitions[PartitionOf(event.target)].wheel.Insert(event);
+}
+
+void SpikingNetwork::Resize(const NeuronPopulation& population)
+{
+	std::vector<Point> positions(population.neurons.size());
+	for (size_t n = 0; n < positions.size(); ++n)
+		positions[n] = population.neurons[n].pos;
+	Resize(positions);
+}
+
+void SpikingNetwork::Stimulate(uint32_t neuron, float weight, uint32_t delay)
+{
+	if (neuron < Neurons())
+		m_Partitions[PartitionOf(neuron)].wheel.Insert({ m_Now + delay, neuron, weight });
+}
+
+size_t SpikingNetwork::Run(const SynapseMatrix& matrix, uint32_t ticks, ThreadPool& pool)
+{
+	if (m_Partitions.empty())
+	{
+		m_Now += ticks;
+		return 0;
+	}
+
+	const size_t   partitions = m_Partitions.size();
+	const uint32_t end        = m_Now + ticks;
+	while (m_Now != end)
+	{
+		uint32_t window = std::min(m_Params.minDelay, end - m_Now);
+		pool.ParallelFor(partitions, 1, [&](size_t begin, size_t last, size_t) {
+			for (size_t p = begin; p < last; ++p)
+				RunPartition(m_Partitions[p], matrix, window);
+		});
+		// Every partition collects the events sent to it, in source partition order.
+		pool.ParallelFor(partitions, 1, [&](size_t begin, size_t last, size_t) {
+			for (size_t q = begin; q < last; ++q)
+			{
+				for (Partition& source : m_Partitions)
+				{
+					for (const SpikeEvent& event : source.outbox[q])
+						m_Partitions[q].wheel.Insert(event);
+					source.outbox[q].clear();
+				}
+			}
+		});
+		m_Now += window;
+	}
+
+	size_t delivered = 0;
+	for (Partition& partition : m_Partitions)
+	{
+		delivered           += partition.delivered;
+		m_Spikes            += partition.spikes;
+		partition.delivered  = 0;
+		partition.spikes     = 0;
+	}
+	return delivered;
+}
+
+void SpikingNetwork::RunPartition(Partition& partition, const SynapseMatrix& matrix, uint32_t ticks)
+{
+	for (uint32_t tick = 0; tick < ticks; ++tick)
+	{
+		partition.wheel.Advance(partition.due);
+		partition.delivered += partition.due.size();
+		for (const SpikeEvent& event : partition.due)
+		{
+			uint32_t n = event.target;
+			if (event.time < m_RefractoryEnd[n])
+				continue;
+
+			uint32_t dt    = event.time - m_LastUpdate[n];
+			float    decay = dt < c_DecayTableSize ? m_DecayTable[dt] : 0.0f;
+			float    v     = m_Voltage[n] * decay + event.weight;
+			m_LastUpdate[n] = event.time;
+			if (v >= m_Params.threshold)
+			{
+				v                  = m_Params.reset;
+				m_RefractoryEnd[n] = event.time + m_Params.refractory;
+				++partition.spikes;
+				Fire(partition, matrix, n, event.time);
+			}
+			m_Voltage[n] = v;
+		}
+	}
+}
+
+// Schedules the spike of neuron along its outgoing synapses, events for the own partition go
+// straight into its wheel as they are due after the current window.
+void SpikingNetwork::Fire(Partition& partition, const SynapseMatrix& matrix, uint32_t neuron, uint32_t time)
+{
+	const SparseRows& outgoing = matrix.Outgoing();
+	if (neuron >= outgoing.Rows())
+		return;
+
+	const uint32_t* index  = outgoing.index.data() + outgoing.start[neuron];
+	const float*    weight = outgoing.weight.data() + outgoing.start[neuron];
+	const Point     pos    = m_Positions[neuron];
+	const size_t    self   = PartitionOf(neuron);
+	for (size_t k = 0; k < outgoing.count[neuron]; ++k)
+	{
+		uint32_t post = index[k];
+		if (post >= Neurons())
+			continue;
+
+		uint32_t   delay = m_Params.minDelay + static_cast<uint32_t>(length(m_Positions[post] - pos) * m_Params.delayPerUnit);
+		SpikeEvent event { time + delay, post, weight[k] };
+		size_t     owner = PartitionOf(post);
+		if (owner == self)
+			partition.wheel.Insert(event);
+		else
+			partition.outbox[owner].push_back(event);
+	}
+}
+
+size_t SpikingNetwork::Pending() const
+{
+	size_t pending = 0;
+	for (const Partition& partition : m_Partitions)
+		pending += partition.wheel.Size();
+	return pending;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Brain.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+class SynapseMatrix;
+class ThreadPool;
+
+// Simulation time is counted in ticks of 0.1 ms, the 32 bit tick counter wraps after about 5 days.
+constexpr float c_SpikeTickMs = 0.1f;
+
+// Input of weight arriving at target at the given tick.
+struct SpikeEvent
+{
+	uint32_t time;
+	uint32_t target;
+	float    weight;
+};
+
+// Hierarchical timing wheel of four 256 slot levels covering the whole 32 bit tick range. An event
+// goes to the lowest level whose slot span still separates it from Now(), so Insert is O(1) and
+// every event cascades down at most three times before it is due. Events of a slot keep their
+// insertion order.
+class TimingWheel
+{
+public:
+	explicit TimingWheel(uint32_t now = 0);
+
+	uint32_t Now() const { return m_Now; }
+	size_t   Size() const { return m_Size; }
+
+	// event.time must not be before Now().
+	void Insert(const SpikeEvent& event);
+	// Replaces out with the events due at Now() and advances Now() by one tick.
+	void Advance(std::vector<SpikeEvent>& out);
+	// Appends every pending event to out and empties the wheel.
+	void Drain(std::vector<SpikeEvent>& out);
+
+private:
+	static constexpr uint32_t c_Bits   = 8;
+	static constexpr uint32_t c_Slots  = 1 << c_Bits;
+	static constexpr uint32_t c_Levels = 4;
+
+	void Cascade(uint32_t level);
+
+	uint32_t                m_Now;
+	size_t                  m_Size = 0;
+	std::vector<SpikeEvent> m_Slots[c_Levels][c_Slots];
+	std::vector<SpikeEvent> m_Scratch;
+};
+
+// Leaky integrate and fire parameters, times are in ticks.
+struct SpikingParams
+{
+	float    threshold    = 1.0f;
+	float    reset        = 0.0f;
+	float    decay        = 0.995f; // Membrane potential factor per tick, about 20 ms time constant.
+	uint32_t refractory   = 20;     // Input arriving within this many ticks after a spike is dropped.
+	uint32_t minDelay     = 10;     // Smallest synaptic delay, at least 1, also the lookahead of the partitions.
+	float    delayPerUnit = 100.0f; // Added delay per unit of distance between pre and post neuron.
+};
+
+// Event driven spiking on top of a SynapseMatrix: a neuron is only touched when input reaches it,
+// its leak since the last update is applied lazily, and a spike schedules one event per outgoing
+// synapse. The neurons are split into at most c_SpikeMaxPartitions contiguous ranges that each own
+// a TimingWheel. Since no delay is shorter than minDelay ticks, the partitions run minDelay ticks
+// on their own in parallel and then exchange the events they produced for each other. The ranges
+// and the exchange order do not depend on the thread count, neither do the results.
+class SpikingNetwork
+{
+public:
+	explicit SpikingNetwork(SpikingParams params = {});
+
+	// Matches the network to the neurons, positions set the synaptic delays. Existing state is kept.
+	void Resize(const std::vector<Point>& positions);
+	void Resize(const NeuronPopulation& population);
+	// Schedules input of weight to neuron, delay ticks from Now().
+	void Stimulate(uint32_t neuron, float weight, uint32_t delay = 0);
+	// Simulates ticks ticks, returns the events delivered.
+	size_t Run(const SynapseMatrix& matrix, uint32_t ticks, ThreadPool& pool);
+
+	const SpikingParams& Params() const { return m_Params; }
+	size_t               Neurons() const { return m_Positions.size(); }
+	uint32_t             Now() const { return m_Now; }
+	// Spikes fired since construction.
+	size_t Spikes() const { return m_Spikes; }
+	// Events scheduled but not yet delivered.
+	size_t Pending() const;
+
+private:
+	static constexpr size_t c_SpikeMaxPartitions = 64;
+	static constexpr size_t c_DecayTableSize     = 4096;
+
+	struct alignas(64) Partition
+	{
+		TimingWheel                          wheel;
+		std::vector<SpikeEvent>              due;
+		std::vector<std::vector<SpikeEvent>> outbox; // Events for every other partition.
+		size_t                               delivered = 0; // Since the start of the current Run.
+		size_t                               spikes    = 0;
+	};
+
+	size_t PartitionOf(uint32_t neuron) const { return neuron / m_PartitionSize; }
+	void   RunPartition(Partition& partition, const SynapseMatrix& matrix, uint32_t ticks);
+	void   Fire(Partition& partition, const SynapseMatrix& matrix, uint32_t neuron, uint32_t time);
+
+	SpikingParams m_Params;
+	uint32_t      m_Now           = 0;
+	size_t        m_PartitionSize = 1;
+	size_t        m_Spikes        = 0;
+
+	std::vector<Partition> m_Partitions;
+	std::vector<Point>     m_Positions;
+	std::vector<float>     m_Voltage;
+	std::vector<uint32_t>  m_LastUpdate;
+	std::vector<uint32_t>  m_RefractoryEnd;
+	std::vector<float>     m_DecayTable; // decay^dt for dt below c_DecayTableSize.
+};
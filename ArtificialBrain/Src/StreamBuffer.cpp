@@ -0,0 +1,53 @@
+#include "StreamBuffer.h"
+
+StreamBuffer::StreamBuffer(size_t regionSize, size_t regionCount)
+	: m_RegionSize(regionSize),
+	  m_RegionCount(regionCount),
+	  m_Region(regionCount - 1),
+	  m_Fences(std::make_unique<GLsync[]>(regionCount))
+{
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &m_Buffer);
+	glNamedBufferStorage(m_Buffer, m_RegionSize * m_RegionCount, nullptr, flags);
+	m_Mapped = static_cast<char*>(glMapNamedBufferRange(m_Buffer, 0, m_RegionSize * m_RegionCount, flags));
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	for (size_t i = 0; i < m_RegionCount; ++i)
+	{
+		if (m_Fences[i])
+			glDeleteSync(m_Fences[i]);
+	}
+	glUnmapNamedBuffer(m_Buffer);
+	glDeleteBuffers(1, &m_Buffer);
+}
+
+void* StreamBuffer::Next()
+{
+	m_Region = (m_Region + 1) % m_RegionCount;
+
+	GLsync& fence = m_Fences[m_Region];
+	if (fence)
+	{
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (true)
+		{
+			GLenum result = glClientWaitSync(fence, flags, 1'000'000);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+				break;
+			flags = 0;
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+	return m_Mapped + Offset();
+}
+
+void StreamBuffer::Fence()
+{
+	GLsync& fence = m_Fences[m_Region];
+	if (fence)
+		glDeleteSync(fence);
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
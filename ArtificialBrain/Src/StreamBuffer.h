@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+#include <memory>
+
+#include <glad/glad.h>
+
+// Persistently mapped GL_ARRAY_BUFFER split into a ring of equally sized regions. The CPU writes
+// the next region straight into mapped memory while the GPU may still read the previous ones,
+// every region is guarded by a fence placed after the last draw that reads it.
+class StreamBuffer
+{
+public:
+	StreamBuffer(size_t regionSize, size_t regionCount = 3);
+	~StreamBuffer();
+
+	StreamBuffer(const StreamBuffer&)            = delete;
+	StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+	GLuint Buffer() const { return m_Buffer; }
+	size_t RegionSize() const { return m_RegionSize; }
+
+	// Moves to the next region, waits until the GPU is done reading it and returns its mapped memory.
+	void* Next();
+	// Byte offset of the current region within Buffer().
+	size_t Offset() const { return m_Region * m_RegionSize; }
+	// Call after submitting the draws that read the current region.
+	void Fence();
+
+private:
+	size_t                    m_RegionSize;
+	size_t                    m_RegionCount;
+	size_t                    m_Region = 0;
+	GLuint                    m_Buffer = 0;
+	char*                     m_Mapped = nullptr;
+	std::unique_ptr<GLsync[]> m_Fences;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Compressed sparse rows, row r holds count[r] (column, weight) entries from start[r] on.
+struct SparseRowsView
+{
+	const uint32_t* start;
+	const uint32_t* count;
+	const uint32_t* index;
+	const float*    weight;
+};
+
+// output[r] = sum of weight * input[index] over row r, for rows [begin, end).
+void PropagateRowsScalar(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end);
+void PropagateRowsSSE41(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end);
+void PropagateRowsAVX2(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end);
+void PropagateRowsAVX512(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end);
@@ -0,0 +1,151 @@
+#include "SynapseMatrix.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <bit>
+
+constexpr uint32_t c_MinRowCapacity = 4;
+
+void PropagateRowsScalar(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end)
+{
+	for (size_t r = begin; r < end; ++r)
+	{
+		const uint32_t* index  = rows.index + rows.start[r];
+		const float*    weight = rows.weight + rows.start[r];
+		float           sum    = 0.0f;
+		for (size_t k = 0; k < rows.count[r]; ++k)
+			sum += weight[k] * input[index[k]];
+		output[r] = sum;
+	}
+}
+
+static void PropagateRows(const SparseRowsView& rows, const float* input, float* output, size_t begin, size_t end)
+{
+	switch (GetSimdKernel())
+	{
+	case SimdKernel::Scalar: PropagateRowsScalar(rows, input, output, begin, end); break;
+	case SimdKernel::SSE41: PropagateRowsSSE41(rows, input, output, begin, end); break;
+	case SimdKernel::AVX2: PropagateRowsAVX2(rows, input, output, begin, end); break;
+	case SimdKernel::AVX512: PropagateRowsAVX512(rows, input, output, begin, end); break;
+	}
+}
+
+static void ResizeRows(SparseRows& rows, size_t count)
+{
+	rows.start.resize(count, 0);
+	rows.count.resize(count, 0);
+	rows.capacity.resize(count, 0);
+}
+
+// Rewrites the rows back to back keeping their capacity, drops the holes.
+static void CompactRows(SparseRows& rows)
+{
+	std::vector<uint32_t> index(rows.index.size() - rows.holes);
+	std::vector<float>    weight(index.size());
+	uint32_t              at = 0;
+	for (size_t r = 0; r < rows.Rows(); ++r)
+	{
+		std::copy_n(rows.index.begin() + rows.start[r], rows.count[r], index.begin() + at);
+		std::copy_n(rows.weight.begin() + rows.start[r], rows.count[r], weight.begin() + at);
+		rows.start[r]  = at;
+		at            += rows.capacity[r];
+	}
+	rows.index.swap(index);
+	rows.weight.swap(weight);
+	rows.holes = 0;
+}
+
+// Appends the entries to their rows, first moving the rows that lack room to the end. Only the rows
+// in the batch are visited, m_Needed is left zeroed for the next call.
+size_t SynapseMatrix::MergeRows(SparseRows& rows, uint32_t Entry::*row, uint32_t Entry::*column)
+{
+	m_Needed.resize(rows.Rows(), 0);
+	for (const Entry& entry : m_Pending)
+		++m_Needed[entry.*row];
+
+	size_t moved = 0;
+	size_t size  = rows.index.size();
+	for (const Entry& entry : m_Pending)
+	{
+		uint32_t r      = entry.*row;
+		uint32_t needed = rows.count[r] + m_Needed[r];
+		m_Needed[r]     = 0;
+		if (needed <= rows.capacity[r])
+			continue;
+
+		uint32_t capacity = std::max(c_MinRowCapacity, std::bit_ceil(needed));
+		rows.index.resize(size + capacity);
+		rows.weight.resize(size + capacity);
+		std::copy_n(rows.index.begin() + rows.start[r], rows.count[r], rows.index.begin() + size);
+		std::copy_n(rows.weight.begin() + rows.start[r], rows.count[r], rows.weight.begin() + size);
+		rows.holes       += rows.capacity[r];
+		rows.start[r]     = static_cast<uint32_t>(size);
+		rows.capacity[r]  = capacity;
+		size             += capacity;
+		++moved;
+	}
+
+	for (const Entry& entry : m_Pending)
+	{
+		uint32_t at     = rows.start[entry.*row] + rows.count[entry.*row]++;
+		rows.index[at]  = entry.*column;
+		rows.weight[at] = entry.weight;
+	}
+
+	if (rows.holes > rows.index.size() / 2)
+		CompactRows(rows);
+	return moved;
+}
+
+SynapseMatrix::SynapseMatrix(size_t neurons)
+{
+	Resize(neurons);
+}
+
+void SynapseMatrix::Resize(size_t neurons)
+{
+	if (neurons < Neurons())
+		return;
+
+	ResizeRows(m_Incoming, neurons);
+	ResizeRows(m_Outgoing, neurons);
+}
+
+void SynapseMatrix::Insert(const Synapse* synapses, size_t count, float weight)
+{
+	m_Pending.reserve(m_Pending.size() + count);
+	for (size_t s = 0; s < count; ++s)
+		m_Pending.push_back({ synapses[s].pre, synapses[s].post, weight });
+}
+
+size_t SynapseMatrix::Commit()
+{
+	if (m_Pending.empty())
+		return 0;
+
+	uint32_t highest = 0;
+	for (const Entry& entry : m_Pending)
+		highest = std::max({ highest, entry.pre, entry.post });
+	Resize(static_cast<size_t>(highest) + 1);
+
+	size_t moved  = MergeRows(m_Incoming, &Entry::post, &Entry::pre);
+	moved        += MergeRows(m_Outgoing, &Entry::pre, &Entry::post);
+
+	m_Size += m_Pending.size();
+	m_Pending.clear();
+	return moved;
+}
+
+void PropagateSignals(const SynapseMatrix& matrix, const float* activity, float* input)
+{
+	PropagateRows(matrix.Incoming().View(), activity, input, 0, matrix.Neurons());
+}
+
+void PropagateSignals(const SynapseMatrix& matrix, const float* activity, float* input, ThreadPool& pool)
+{
+	SparseRowsView rows = matrix.Incoming().View();
+	pool.ParallelFor(matrix.Neurons(), 1024, [&](size_t begin, size_t end, size_t) {
+		PropagateRows(rows, activity, input, begin, end);
+	});
+}
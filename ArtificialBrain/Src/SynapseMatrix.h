@@ -0,0 +1,72 @@
+#pragma once
+
+#include "SynapseKernel.h"
+#include "Synapses.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+class ThreadPool;
+
+// Weight given to synapses inserted without a learned weight.
+constexpr float c_SynapseWeight = 0.5f;
+
+// Sparse rows with slack, row r owns capacity[r] entries of index and weight from start[r] on, of
+// which the first count[r] are used. Rows are not kept in order, a row that outgrows its slot is
+// moved to the end and leaves a hole.
+struct SparseRows
+{
+	std::vector<uint32_t> start;
+	std::vector<uint32_t> count;
+	std::vector<uint32_t> capacity;
+	std::vector<uint32_t> index;
+	std::vector<float>    weight;
+	size_t                holes = 0; // Entries of index and weight no row owns.
+
+	size_t         Rows() const { return count.size(); }
+	SparseRowsView View() const { return { start.data(), count.data(), index.data(), weight.data() }; }
+};
+
+// Weighted synapse matrix kept both as CSR by post neuron (the incoming rows PropagateSignals
+// pulls from) and CSC by pre neuron (the outgoing rows, for delivering events). New synapses are
+// queued with Insert and merged in batches by Commit: every row carries slack so most of a batch
+// is written in place, a row running out of room moves to the end of the arrays with its capacity
+// raised to the next power of two, and the arrays are compacted once holes outnumber synapses.
+class SynapseMatrix
+{
+public:
+	explicit SynapseMatrix(size_t neurons = 0);
+
+	// Grows the matrix to neurons rows and columns, existing synapses are kept.
+	void Resize(size_t neurons);
+	void Insert(const Synapse* synapses, size_t count, float weight);
+	// Merges the queued synapses, returns the number of rows that had to be moved.
+	size_t Commit();
+
+	size_t            Neurons() const { return m_Incoming.Rows(); }
+	size_t            Size() const { return m_Size; }
+	const SparseRows& Incoming() const { return m_Incoming; }
+	const SparseRows& Outgoing() const { return m_Outgoing; }
+
+private:
+	struct Entry
+	{
+		uint32_t pre;
+		uint32_t post;
+		float    weight;
+	};
+
+	size_t MergeRows(SparseRows& rows, uint32_t Entry::*row, uint32_t Entry::*column);
+
+	std::vector<Entry>    m_Pending;
+	SparseRows            m_Incoming;
+	SparseRows            m_Outgoing;
+	std::vector<uint32_t> m_Needed; // Per row batch counts, zero between MergeRows calls.
+	size_t                m_Size = 0;
+};
+
+// input[post] = sum of weight * activity[pre] over the incoming synapses of post.
+void PropagateSignals(const SynapseMatrix& matrix, const float* activity, float* input);
+void PropagateSignals(const SynapseMatrix& matrix, const float* activity, float* input, ThreadPool& pool);
@@ -0,0 +1,136 @@
+#include "Synapses.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+// Orders the points of equally distant contacts, so the contact does not depend on which grid
+// indexes a point or where it sits in its cell.
+static bool IsBefore(const GridPoint& lhs, const GridPoint& rhs)
+{
+	if (lhs.neuron != rhs.neuron)
+		return lhs.neuron < rhs.neuron;
+	return lhs.dendrite != rhs.dendrite ? lhs.dendrite < rhs.dendrite : lhs.point < rhs.point;
+}
+
+SynapseFormation::SynapseFormation(float contactRadius)
+	: m_ContactRadius(contactRadius),
+	  m_Settled(contactRadius),
+	  m_Moving(contactRadius)
+{
+}
+
+// Indexes the neurons that can still grow in m_Moving, along with the stopped ones not yet in
+// m_Settled. Those are merged into m_Settled once they are at least half its size.
+void SynapseFormation::UpdateGrids(const NeuronPopulation& population, ThreadPool& pool)
+{
+	const auto& neurons = population.neurons;
+	if (m_InSettled.size() != neurons.size())
+	{
+		m_InSettled.assign(neurons.size(), 0);
+		m_SettledNeurons.clear();
+		m_Settled.Build(neurons, m_SettledNeurons, pool);
+	}
+
+	m_Growing.assign(neurons.size(), 0);
+	for (uint32_t n : population.active)
+		m_Growing[n] = 1;
+
+	size_t stopped = 0;
+	for (size_t n = 0; n < neurons.size(); ++n)
+		stopped += !m_InSettled[n] && !m_Growing[n];
+	if (stopped != 0 && 2 * stopped >= m_SettledNeurons.size())
+	{
+		m_SettledNeurons.clear();
+		for (size_t n = 0; n < neurons.size(); ++n)
+		{
+			m_InSettled[n] |= !m_Growing[n];
+			if (m_InSettled[n])
+				m_SettledNeurons.push_back(static_cast<uint32_t>(n));
+		}
+		m_Settled.Build(neurons, m_SettledNeurons, pool);
+	}
+
+	m_MovingNeurons.clear();
+	for (size_t n = 0; n < neurons.size(); ++n)
+		if (!m_InSettled[n])
+			m_MovingNeurons.push_back(static_cast<uint32_t>(n));
+	m_Moving.Build(neurons, m_MovingNeurons, pool);
+}
+
+size_t SynapseFormation::Step(const NeuronPopulation& population, ThreadPool& pool)
+{
+	const auto& neurons = population.neurons;
+	if (neurons.empty())
+		return 0;
+
+	const size_t dendrites = neurons[0].Dendrites();
+	const size_t tip       = neurons[0].Points() - 1;
+	m_Connected.resize(neurons.size() * dendrites);
+	m_Buffers.resize(pool.ThreadCount());
+	for (auto& buffer : m_Buffers)
+	{
+		buffer.synapses.clear();
+		buffer.tested = 0;
+	}
+
+	if (!IsGridShapeSupported(neurons[0].Shape(), neurons.size()))
+		return 0;
+
+	UpdateGrids(population, pool);
+	pool.ParallelFor(neurons.size(), 64, [&](size_t begin, size_t end, size_t thread) {
+		ThreadBuffer& buffer = m_Buffers[thread];
+		for (size_t n = begin; n < end; ++n)
+		{
+			const NeuronSoA& neuron    = neurons[n];
+			const uint8_t*   connected = m_Connected.data() + n * dendrites;
+			for (size_t i = 0; i < dendrites; ++i)
+			{
+				if (connected[i])
+					continue;
+
+				Point     center  = neuron.pos + Point { neuron.X(tip)[i], neuron.Y(tip)[i] };
+				float     closest = 0.0f;
+				GridPoint contact {};
+				bool      found   = false;
+				auto      visit   = [&](const GridPoint& point, float distSq) {
+					if (point.neuron != n && (!found || distSq < closest || (distSq == closest && IsBefore(point, contact))))
+					{
+						closest = distSq;
+						contact = point;
+						found   = true;
+					}
+				};
+				m_Settled.ForEachInRadius(center, m_ContactRadius, visit);
+				m_Moving.ForEachInRadius(center, m_ContactRadius, visit);
+				++buffer.tested;
+				if (found)
+					buffer.synapses.push_back({ static_cast<uint32_t>(n), contact.neuron, static_cast<uint32_t>(i), contact.dendrite, contact.point });
+			}
+		}
+	});
+
+	// Each buffer copies into its own slice, the slices are sorted afterwards so the order does
+	// not depend on which thread ran which chunk.
+	size_t first  = m_Synapses.size();
+	size_t offset = first;
+	m_Tested      = 0;
+	std::vector<size_t> offsets(m_Buffers.size());
+	for (size_t t = 0; t < m_Buffers.size(); ++t)
+	{
+		offsets[t]  = offset;
+		offset     += m_Buffers[t].synapses.size();
+		m_Tested   += m_Buffers[t].tested;
+	}
+	m_Synapses.resize(offset);
+	pool.ParallelFor(m_Buffers.size(), 1, [&](size_t begin, size_t end, size_t) {
+		for (size_t t = begin; t < end; ++t)
+			std::copy(m_Buffers[t].synapses.begin(), m_Buffers[t].synapses.end(), m_Synapses.begin() + offsets[t]);
+	});
+	std::sort(m_Synapses.begin() + first, m_Synapses.end(), [](const Synapse& lhs, const Synapse& rhs) {
+		return lhs.pre != rhs.pre ? lhs.pre < rhs.pre : lhs.preDendrite < rhs.preDendrite;
+	});
+
+	for (size_t s = first; s < m_Synapses.size(); ++s)
+		m_Connected[m_Synapses[s].pre * dendrites + m_Synapses[s].preDendrite] = 1;
+	return m_Synapses.size() - first;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Brain.h"
+#include "SpatialGrid.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+class ThreadPool;
+
+// A dendrite tip of pre touching a dendrite point of post.
+struct Synapse
+{
+	uint32_t pre;
+	uint32_t post;
+	uint32_t preDendrite;
+	uint32_t postDendrite : 24;
+	uint32_t postPoint    : 8;
+};
+
+// Forms synapses where a dendrite tip comes within contactRadius of another neuron's dendrite.
+// Each dendrite tip forms at most one synapse, with the closest point in reach, ties going to the
+// lowest (neuron, dendrite, point). Neurons that stopped growing never move again and are kept in
+// a settled SpatialGrid, only the rest are indexed anew every step. Stopped neurons are added to
+// the settled grid once they make up half of it, so each point is re-indexed a bounded number of
+// times. The unconnected tips are tested in parallel, contacts go to per thread buffers that are
+// then copied into disjoint slices of the synapse list, so no locks are taken and the result is
+// sorted by (pre, preDendrite) regardless of the thread count.
+class SynapseFormation
+{
+public:
+	explicit SynapseFormation(float contactRadius);
+
+	// Call after every GrowPopulation, returns the synapses formed in this step. Forms none when
+	// the population exceeds IsGridShapeSupported.
+	size_t Step(const NeuronPopulation& population, ThreadPool& pool);
+
+	float                       ContactRadius() const { return m_ContactRadius; }
+	const std::vector<Synapse>& Synapses() const { return m_Synapses; }
+	// Tips tested in the last Step.
+	size_t Tested() const { return m_Tested; }
+
+private:
+	struct alignas(64) ThreadBuffer
+	{
+		std::vector<Synapse> synapses;
+		size_t               tested = 0;
+	};
+
+	void UpdateGrids(const NeuronPopulation& population, ThreadPool& pool);
+
+	float       m_ContactRadius;
+	SpatialGrid m_Settled;
+	SpatialGrid m_Moving;
+
+	std::vector<uint8_t>      m_InSettled; // Per neuron, set once it is indexed by m_Settled.
+	std::vector<uint8_t>      m_Growing;   // Per neuron, scratch copy of population.active.
+	std::vector<uint32_t>     m_SettledNeurons;
+	std::vector<uint32_t>     m_MovingNeurons;
+	std::vector<Synapse>      m_Synapses;
+	std::vector<uint8_t>      m_Connected; // Per neuron and dendrite, set once its tip formed a synapse.
+	std::vector<ThreadBuffer> m_Buffers;
+	size_t                    m_Tested = 0;
+};
@@ -0,0 +1,154 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+static uint64_t PackRange(uint64_t begin, uint64_t end)
+{
+	return begin << 32 | end;
+}
+
+static void UnpackRange(uint64_t range, size_t& begin, size_t& end)
+{
+	begin = static_cast<size_t>(range >> 32);
+	end   = static_cast<size_t>(range & 0xFFFF'FFFF);
+}
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	m_ThreadCount = threadCount;
+	m_Ranges      = std::make_unique<WorkRange[]>(threadCount);
+
+	m_Threads.reserve(threadCount - 1);
+	for (size_t i = 1; i < threadCount; ++i)
+		m_Threads.emplace_back(&ThreadPool::WorkerMain, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Stop = true;
+	}
+	m_WorkCV.notify_all();
+	for (auto& thread : m_Threads)
+		thread.join();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const ParallelForFn& fn)
+{
+	if (count == 0)
+		return;
+	grain         = std::max<size_t>(grain, 1);
+	size_t chunks = (count + grain - 1) / grain;
+	if (m_ThreadCount == 1 || chunks == 1)
+	{
+		for (size_t begin = 0; begin < count; begin += grain)
+			fn(begin, std::min(begin + grain, count), 0);
+		return;
+	}
+
+	{
+		std::unique_lock lock(m_Mutex);
+		m_DoneCV.wait(lock, [this]() { return m_Active == 0; });
+
+		m_Count  = count;
+		m_Grain  = grain;
+		m_Chunks = chunks;
+		m_Completed.store(0, std::memory_order_relaxed);
+		for (size_t i = 0; i < m_ThreadCount; ++i)
+			m_Ranges[i].range.store(PackRange(i * chunks / m_ThreadCount, (i + 1) * chunks / m_ThreadCount), std::memory_order_relaxed);
+		m_Job = &fn;
+		++m_Generation;
+		++m_Active;
+	}
+	m_WorkCV.notify_all();
+
+	RunChunks(0, fn);
+
+	std::unique_lock lock(m_Mutex);
+	--m_Active;
+	m_DoneCV.wait(lock, [this]() { return m_Active == 0 && m_Completed.load(std::memory_order_acquire) == m_Chunks; });
+	m_Job = nullptr;
+}
+
+void ThreadPool::WorkerMain(size_t thread)
+{
+	size_t generation = 0;
+	while (true)
+	{
+		const ParallelForFn* job = nullptr;
+		{
+			std::unique_lock lock(m_Mutex);
+			m_WorkCV.wait(lock, [&]() { return m_Stop || m_Generation != generation; });
+			if (m_Stop)
+				return;
+			generation = m_Generation;
+			job        = m_Job;
+			if (!job)
+				continue;
+			++m_Active;
+		}
+
+		RunChunks(thread, *job);
+
+		{
+			std::lock_guard lock(m_Mutex);
+			--m_Active;
+		}
+		m_DoneCV.notify_all();
+	}
+}
+
+void ThreadPool::RunChunks(size_t thread, const ParallelForFn& fn)
+{
+	size_t chunk;
+	while (PopChunk(thread, chunk) || (StealChunks(thread) && PopChunk(thread, chunk)))
+	{
+		size_t begin = chunk * m_Grain;
+		fn(begin, std::min(begin + m_Grain, m_Count), thread);
+		m_Completed.fetch_add(1, std::memory_order_release);
+	}
+}
+
+bool ThreadPool::PopChunk(size_t thread, size_t& chunk)
+{
+	auto&    own   = m_Ranges[thread].range;
+	uint64_t range = own.load(std::memory_order_acquire);
+	while (true)
+	{
+		size_t begin, end;
+		UnpackRange(range, begin, end);
+		if (begin >= end)
+			return false;
+		if (own.compare_exchange_weak(range, PackRange(begin + 1, end), std::memory_order_acq_rel))
+		{
+			chunk = begin;
+			return true;
+		}
+	}
+}
+
+bool ThreadPool::StealChunks(size_t thread)
+{
+	for (size_t offset = 1; offset < m_ThreadCount; ++offset)
+	{
+		auto&    victim = m_Ranges[(thread + offset) % m_ThreadCount].range;
+		uint64_t range  = victim.load(std::memory_order_acquire);
+		while (true)
+		{
+			size_t begin, end;
+			UnpackRange(range, begin, end);
+			if (begin >= end)
+				break;
+			size_t split = end - (end - begin + 1) / 2;
+			if (victim.compare_exchange_weak(range, PackRange(begin, split), std::memory_order_acq_rel))
+			{
+				m_Ranges[thread].range.store(PackRange(split, end), std::memory_order_release);
+				return true;
+			}
+		}
+	}
+	return false;
+}
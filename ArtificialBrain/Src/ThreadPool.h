@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using ParallelForFn = std::function<void(size_t begin, size_t end, size_t thread)>;
+
+class ThreadPool
+{
+public:
+	explicit ThreadPool(size_t threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&)            = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	size_t ThreadCount() const { return m_ThreadCount; }
+
+	// Calls fn over [0, count) in chunks of at most grain elements, the calling thread is worker 0.
+	void ParallelFor(size_t count, size_t grain, const ParallelForFn& fn);
+
+private:
+	struct alignas(64) WorkRange
+	{
+		std::atomic<uint64_t> range { 0 };
+	};
+
+	void WorkerMain(size_t thread);
+	void RunChunks(size_t thread, const ParallelForFn& fn);
+	bool PopChunk(size_t thread, size_t& chunk);
+	bool StealChunks(size_t thread);
+
+	size_t                       m_ThreadCount;
+	std::vector<std::thread>     m_Threads;
+	std::unique_ptr<WorkRange[]> m_Ranges;
+
+	std::mutex              m_Mutex;
+	std::condition_variable m_WorkCV;
+	std::condition_variable m_DoneCV;
+	const ParallelForFn*    m_Job        = nullptr;
+	size_t                  m_Generation = 0;
+	size_t                  m_Active     = 0;
+	bool                    m_Stop       = false;
+
+	size_t              m_Count  = 0;
+	size_t              m_Grain  = 0;
+	size_t              m_Chunks = 0;
+	std::atomic<size_t> m_Completed { 0 };
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Single producer, single consumer. The producer fills Back() and publishes it, the consumer
+// picks up the most recently published buffer with Update() and reads it through Front().
+template <class T>
+class TripleBuffer
+{
+public:
+	T&       Back() { return m_Buffers[m_Back]; }
+	const T& Front() const { return m_Buffers[m_Front]; }
+
+	void Publish()
+	{
+		m_Back = m_Middle.exchange(m_Back | c_Fresh, std::memory_order_acq_rel) & c_Index;
+	}
+
+	bool Update()
+	{
+		if (!(m_Middle.load(std::memory_order_relaxed) & c_Fresh))
+			return false;
+		m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & c_Index;
+		return true;
+	}
+
+private:
+	static constexpr uint8_t c_Index = 0x3;
+	static constexpr uint8_t c_Fresh = 0x4;
+
+	T                    m_Buffers[3];
+	uint8_t              m_Back  = 0;
+	uint8_t              m_Front = 1;
+	std::atomic<uint8_t> m_Middle { 2 };
+};
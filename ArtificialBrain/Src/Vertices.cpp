@@ -0,0 +1,63 @@
+#include "Vertices.h"
+
+#include <algorithm>
+
+void BuildRenderNeurons(const std::vector<NeuronSoA>& neurons, RenderNeuron* renderNeurons)
+{
+	for (auto& neuron : neurons)
+		*renderNeurons++ = { neuron.pos, static_cast<uint32_t>(neuron.longest), static_cast<uint32_t>(neuron.furthest) };
+}
+
+size_t BuildLineSegments(const std::vector<NeuronSoA>& neurons, Vertex* vertices)
+{
+	size_t index = 0;
+	for (auto& neuron : neurons)
+	{
+		for (size_t i = 0; i < neuron.Dendrites(); ++i)
+		{
+			for (size_t j = 0; j + 1 < neuron.Points(); ++j)
+			{
+				vertices[index++] = { neuron.pos + Point { neuron.X(j)[i], neuron.Y(j)[i] } };
+				vertices[index++] = { neuron.pos + Point { neuron.X(j + 1)[i], neuron.Y(j + 1)[i] } };
+			}
+		}
+	}
+	return index;
+}
+
+std::vector<uint32_t> BuildLineStripIndices(size_t dendrites, size_t points)
+{
+	std::vector<uint32_t> indices;
+	indices.reserve(dendrites * (points + 1));
+	for (size_t i = 0; i < dendrites; ++i)
+	{
+		for (size_t j = 0; j < points; ++j)
+			indices.push_back(static_cast<uint32_t>(i * points + j));
+		indices.push_back(0xFFFF'FFFF);
+	}
+	return indices;
+}
+
+static int16_t Quantize(float value)
+{
+	return static_cast<int16_t>(std::clamp(value * c_CompactPositionScale, -32767.0f, 32767.0f));
+}
+
+size_t BuildCompactVertices(const std::vector<NeuronSoA>& neurons, CompactVertex* vertices)
+{
+	size_t index = 0;
+	for (auto& neuron : neurons)
+	{
+		const size_t dendrites = neuron.Dendrites();
+		const size_t points    = neuron.Points();
+		for (size_t j = 0; j < points; ++j)
+		{
+			const float* x = neuron.X(j);
+			const float* y = neuron.Y(j);
+			for (size_t i = 0; i < dendrites; ++i)
+				vertices[index + i * points + j] = { Quantize(x[i]), Quantize(y[i]) };
+		}
+		index += dendrites * points;
+	}
+	return index;
+}
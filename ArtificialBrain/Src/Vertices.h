@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Brain.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+struct Vertex
+{
+	Point pos;
+};
+
+// Per neuron shader storage entry, the shaders color the longest dendrite red, the furthest
+// green and the rest blue from gl_VertexID so vertices carry positions only.
+struct RenderNeuron
+{
+	Point    pos;
+	uint32_t longest;
+	uint32_t furthest;
+};
+
+void BuildRenderNeurons(const std::vector<NeuronSoA>& neurons, RenderNeuron* renderNeurons);
+
+constexpr size_t LineVerticesPerNeuron(NeuronShape shape)
+{
+	return 2 * shape.dendrites * (shape.points - 1);
+}
+
+// Writes GL_LINES vertices for every dendrite into vertices, which must hold LineVerticesPerNeuron per neuron.
+size_t BuildLineSegments(const std::vector<NeuronSoA>& neurons, Vertex* vertices);
+
+// Compact mode, one GL_LINE_STRIP per dendrite. Points are stored relative to their neuron in
+// 1 / c_CompactPositionScale fixed point, the shader adds RenderNeuron::pos.
+constexpr float c_CompactPositionScale = 2048.0f;
+
+struct CompactVertex
+{
+	int16_t x, y;
+};
+
+constexpr size_t CompactVerticesPerNeuron(NeuronShape shape)
+{
+	return shape.dendrites * shape.points;
+}
+
+// Line strip indices for dendrites dendrites of points points each, separated by 0xFFFF'FFFF restarts.
+std::vector<uint32_t> BuildLineStripIndices(size_t dendrites, size_t points);
+
+// Writes CompactVerticesPerNeuron vertices per neuron, returns the vertex count.
+size_t BuildCompactVertices(const std::vector<NeuronSoA>& neurons, CompactVertex* vertices);
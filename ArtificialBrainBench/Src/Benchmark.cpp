@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <string_view>
+
+struct Benchmark
+{
+	std::string                       name;
+	BenchmarkFn                       fn;
+	std::vector<std::vector<int64_t>> args;
+};
+
+static std::vector<Benchmark>& Benchmarks()
+{
+	static std::vector<Benchmark> s_Benchmarks;
+	return s_Benchmarks;
+}
+
+void RegisterBenchmark(std::string name, BenchmarkFn fn, std::vector<std::vector<int64_t>> args)
+{
+	Benchmarks().push_back({ std::move(name), fn, std::move(args) });
+}
+
+static std::string BenchmarkName(const Benchmark& benchmark, const std::vector<int64_t>& args)
+{
+	std::string name = benchmark.name;
+	for (int64_t arg : args)
+		name += "/" + std::to_string(arg);
+	return name;
+}
+
+static std::string FormatRate(double rate)
+{
+	const char* suffixes[] = { "", "k", "M", "G", "T" };
+	size_t      suffix     = 0;
+	while (rate >= 1000.0 && suffix < 4)
+	{
+		rate /= 1000.0;
+		++suffix;
+	}
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%.4g%s/s", rate, suffixes[suffix]);
+	return buffer;
+}
+
+int RunBenchmarks(int argc, char** argv)
+{
+	std::string_view filter;
+	double           minTime = 0.5;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		if (arg.starts_with("--filter="))
+		{
+			filter = arg.substr(9);
+		}
+		else if (arg.starts_with("--min-time="))
+		{
+			minTime = std::max(std::strtod(argv[i] + 11, nullptr), 0.0);
+		}
+		else
+		{
+			std::printf("Unknown argument '%s', expected --filter=<substring> or --min-time=<seconds>\n", argv[i]);
+			return 1;
+		}
+	}
+
+	std::printf("%-48s %14s %12s %16s %10s\n", "Benchmark", "Time", "Iterations", "Segments", "Error");
+	std::printf("%s\n", std::string(104, '-').c_str());
+	for (auto& benchmark : Benchmarks())
+	{
+		for (auto& args : benchmark.args)
+		{
+			std::string name = BenchmarkName(benchmark, args);
+			if (name.find(filter) == std::string::npos)
+				continue;
+
+			size_t iterations = 1;
+			while (true)
+			{
+				BenchmarkState state(iterations, args);
+				benchmark.fn(state);
+				double seconds = state.Seconds();
+				if (seconds >= minTime || iterations >= 1'000'000'000)
+				{
+					std::printf("%-48s %11.1f ns %12zu", name.c_str(), seconds * 1e9 / iterations, iterations);
+					std::printf(" %16s", state.ItemsProcessed() ? FormatRate(state.ItemsProcessed() / seconds).c_str() : "");
+					if (state.Error() >= 0.0)
+						std::printf(" %10.3g", state.Error());
+					else
+						std::printf(" %10s", "");
+					if (!state.Label().empty())
+						std::printf(" %s", state.Label().c_str());
+					std::printf("\n");
+					break;
+				}
+
+				double scale = seconds > 0.0 ? minTime * 1.4 / seconds : 10.0;
+				iterations   = std::max<size_t>(iterations + 1, static_cast<size_t>(iterations * std::min(scale, 10.0)));
+			}
+		}
+	}
+	return 0;
+}
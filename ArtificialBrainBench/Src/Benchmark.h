@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class BenchmarkState
+{
+public:
+	BenchmarkState(size_t iterations, std::vector<int64_t> args)
+	    : m_Iterations(iterations), m_Args(std::move(args)) {}
+
+	// Returns true until the requested number of iterations have run, timing starts on the first call.
+	bool KeepRunning()
+	{
+		if (m_Done == 0 && !m_Running)
+			ResumeTiming();
+		if (m_Done < m_Iterations)
+		{
+			++m_Done;
+			return true;
+		}
+		PauseTiming();
+		return false;
+	}
+
+	void PauseTiming()
+	{
+		if (!m_Running)
+			return;
+		m_Elapsed += Clock::now() - m_Start;
+		m_Running  = false;
+	}
+
+	void ResumeTiming()
+	{
+		m_Start   = Clock::now();
+		m_Running = true;
+	}
+
+	int64_t Arg(size_t index) const { return m_Args[index]; }
+	size_t  Iterations() const { return m_Iterations; }
+
+	void SetItemsProcessed(size_t items) { m_Items = items; }
+	void SetError(double error) { m_Error = error; }
+	void SetLabel(std::string label) { m_Label = std::move(label); }
+
+	double             Seconds() const { return std::chrono::duration<double>(m_Elapsed).count(); }
+	size_t             ItemsProcessed() const { return m_Items; }
+	double             Error() const { return m_Error; }
+	const std::string& Label() const { return m_Label; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	size_t               m_Iterations;
+	std::vector<int64_t> m_Args;
+	size_t               m_Done    = 0;
+	bool                 m_Running = false;
+	Clock::time_point    m_Start;
+	Clock::duration      m_Elapsed { 0 };
+
+	size_t      m_Items = 0;
+	double      m_Error = -1.0;
+	std::string m_Label;
+};
+
+using BenchmarkFn = void (*)(BenchmarkState& state);
+
+void RegisterBenchmark(std::string name, BenchmarkFn fn, std::vector<std::vector<int64_t>> args = { {} });
+int  RunBenchmarks(int argc, char** argv);
+
+template <class T>
+inline void DoNotOptimize(T& value)
+{
+#if defined(_MSC_VER)
+	static volatile const void* s_Sink;
+	s_Sink = &value;
+#else
+	asm volatile("" : "+m"(value) : : "memory");
+#endif
+}
@@ -0,0 +1,935 @@
+#include "Benchmark.h"
+#include "Brain.h"
+#include "Cable.h"
+#include "Checkpoint.h"
+#include "GrowKernel.h"
+#include "Random.h"
+#include "Rasterizer.h"
+#include "Simd.h"
+#include "SpatialGrid.h"
+#include "Spiking.h"
+#include "SynapseMatrix.h"
+#include "Synapses.h"
+#include "ThreadPool.h"
+#include "Vertices.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+template <class NeuronT>
+void BenchInitNeuron(BenchmarkState& state)
+{
+	auto     neuron = std::make_unique<NeuronT>();
+	uint32_t id     = 0;
+	while (state.KeepRunning())
+	{
+		InitNeuron(*neuron, { 0.0f, 0.0f }, 0, id++);
+		DoNotOptimize(*neuron);
+	}
+}
+
+// Steps grown per iteration by the GrowNeuron and GrowPopulation benchmarks, each iteration first
+// restores the starting state untimed. Growth gets cheaper as dendrites saturate, by about step
+// 2000 for a fresh neuron, so growing one neuron for as many steps as the harness picks would make
+// the time per step depend on the iteration count.
+constexpr size_t c_NeuronWindow     = 256;
+constexpr size_t c_PopulationWindow = 32;
+
+template <class NeuronT>
+size_t GrowNeuronWindow(BenchmarkState& state, const NeuronT& start)
+{
+	auto   neuron   = std::make_unique<NeuronT>(start);
+	size_t segments = 0;
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		*neuron = start;
+		state.ResumeTiming();
+		for (size_t i = 0; i < c_NeuronWindow; ++i)
+			segments += GrowNeuron(*neuron);
+	}
+	return segments;
+}
+
+// AoS and SoA grow the same window from a fresh InitNeuron, so their rows compare the same steps.
+template <class NeuronT>
+void BenchGrowNeuron(BenchmarkState& state)
+{
+	auto neuron = std::make_unique<NeuronT>();
+	InitNeuron(*neuron);
+	state.SetItemsProcessed(GrowNeuronWindow(state, *neuron));
+}
+
+// Arg(0) warm up steps, most dendrites have reached their maxLength after a few thousand.
+template <class NeuronT>
+void BenchGrowNeuronGrown(BenchmarkState& state)
+{
+	SetGrowKernel(BestSimdKernel());
+	SetGrowthMode(GrowthMode::Vector);
+
+	auto neuron = std::make_unique<NeuronT>();
+	InitNeuron(*neuron);
+	for (int64_t i = 0; i < state.Arg(0); ++i)
+		GrowNeuron(*neuron);
+	state.SetItemsProcessed(GrowNeuronWindow(state, *neuron));
+}
+
+template <GrowthMode Mode, SimdKernel Kernel>
+void BenchGrowNeuronSoA(BenchmarkState& state)
+{
+	SetGrowKernel(Kernel);
+	SetGrowthMode(Mode);
+	BenchGrowNeuron<NeuronSoA>(state);
+	state.SetError(VerifyGrowKernel(Kernel, Mode));
+	if (Kernel == SimdKernel::Scalar)
+		return;
+
+	// The same windows from the same fresh neuron on the scalar kernel give the speedup.
+	using Clock = std::chrono::steady_clock;
+	SetGrowKernel(SimdKernel::Scalar);
+	auto start  = std::make_unique<NeuronSoA>();
+	auto neuron = std::make_unique<NeuronSoA>();
+	InitNeuron(*start);
+	Clock::duration scalar { 0 };
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		*neuron    = *start;
+		auto begin = Clock::now();
+		for (size_t j = 0; j < c_NeuronWindow; ++j)
+			GrowNeuron(*neuron);
+		scalar += Clock::now() - begin;
+	}
+	SetGrowKernel(Kernel);
+
+	char label[64];
+	std::snprintf(label, sizeof(label), "%.2fx scalar", std::chrono::duration<double>(scalar).count() / state.Seconds());
+	state.SetLabel(label);
+}
+
+template <size_t N, GrowthMode Mode>
+void BenchGrowNeurite(BenchmarkState& state)
+{
+	SetGrowthMode(Mode);
+
+	Point points[N] {};
+	points[N - 1] = { 1.0f, 0.0f };
+	float growth[64];
+	float dAngle[64];
+	for (size_t i = 0; i < 64; ++i)
+	{
+		float random[4];
+		RandomUniform(0, 0, 0, i, random);
+		growth[i] = random[0];
+		dAngle[i] = (random[1] - 0.5f) * random[0];
+	}
+
+	size_t segments = 0;
+	size_t step     = 0;
+	float  len      = 1.0f;
+	while (state.KeepRunning())
+	{
+		if (GrowNeurite(points, len, 1e30f, growth[step % 64], dAngle[step % 64]))
+			segments += N - 1;
+		++step;
+	}
+	DoNotOptimize(points);
+	state.SetItemsProcessed(segments);
+}
+
+template <GrowthMode Mode, SimdKernel Kernel>
+void BenchGrowNeurites(BenchmarkState& state)
+{
+	SetGrowKernel(Kernel);
+	SetGrowthMode(Mode);
+
+	NeuronShape shape  = { static_cast<size_t>(state.Arg(0)), static_cast<size_t>(state.Arg(1)) };
+	auto        neuron = std::make_unique<NeuronSoA>(shape);
+	InitNeuron(*neuron);
+	std::vector<float> growth(shape.dendrites);
+	std::vector<float> dAngle(shape.dendrites);
+	for (size_t i = 0; i < shape.dendrites; ++i)
+	{
+		float random[4];
+		RandomUniform(0, 0, static_cast<uint32_t>(i), 0, random);
+		neuron->MaxLength()[i] = 1e30f;
+		growth[i]              = random[0];
+		dAngle[i]              = (random[1] - 0.5f) * random[0];
+	}
+
+	size_t segments = 0;
+	while (state.KeepRunning())
+		segments += (shape.points - 1) * GrowNeurites(neuron->Lanes(), growth.data(), dAngle.data(), 0, shape.dendrites);
+	state.SetItemsProcessed(segments);
+	state.SetError(VerifyGrowKernel(Kernel, Mode, shape));
+}
+
+void BenchGrowNeuronShape(BenchmarkState& state)
+{
+	SetGrowKernel(BestSimdKernel());
+	SetGrowthMode(GrowthMode::Vector);
+
+	auto neuron = std::make_unique<NeuronSoA>(NeuronShape { static_cast<size_t>(state.Arg(0)), static_cast<size_t>(state.Arg(1)) });
+	InitNeuron(*neuron);
+	state.SetItemsProcessed(GrowNeuronWindow(state, *neuron));
+}
+
+#if defined(_MSC_VER)
+	#define BENCH_NOINLINE __declspec(noinline)
+#else
+	#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+// The point math as it was before Point.h, every operator a call into another translation unit.
+// Kept as the baseline the header only operators are measured against.
+struct OutOfLinePoint
+{
+	float x, y;
+};
+
+BENCH_NOINLINE OutOfLinePoint operator+(OutOfLinePoint lhs, OutOfLinePoint rhs)
+{
+	return { lhs.x + rhs.x, lhs.y + rhs.y };
+}
+BENCH_NOINLINE OutOfLinePoint operator-(OutOfLinePoint lhs, OutOfLinePoint rhs)
+{
+	return { lhs.x - rhs.x, lhs.y - rhs.y };
+}
+BENCH_NOINLINE OutOfLinePoint operator*(OutOfLinePoint lhs, OutOfLinePoint rhs)
+{
+	return { lhs.x * rhs.x, lhs.y * rhs.y };
+}
+BENCH_NOINLINE OutOfLinePoint operator*(OutOfLinePoint lhs, float rhs)
+{
+	return { lhs.x * rhs, lhs.y * rhs };
+}
+BENCH_NOINLINE OutOfLinePoint operator/(OutOfLinePoint lhs, OutOfLinePoint rhs)
+{
+	return { lhs.x / rhs.x, lhs.y / rhs.y };
+}
+BENCH_NOINLINE OutOfLinePoint operator/(OutOfLinePoint lhs, float rhs)
+{
+	return { lhs.x / rhs, lhs.y / rhs };
+}
+inline OutOfLinePoint& operator+=(OutOfLinePoint& lhs, OutOfLinePoint rhs)
+{
+	return lhs = lhs + rhs;
+}
+
+template <class PointT>
+void BenchPointOperators(BenchmarkState& state)
+{
+	size_t              count = static_cast<size_t>(state.Arg(0));
+	std::vector<PointT> a(count);
+	std::vector<PointT> b(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		a[i] = { static_cast<float>(i), 1.0f };
+		b[i] = { 1.0f, static_cast<float>(i + 1) };
+	}
+
+	while (state.KeepRunning())
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			PointT p = (a[i] + b[i]) * 0.5f - a[i] / b[i];
+			p       += b[i] * a[i];
+			a[i]     = p / 1024.0f;
+		}
+		DoNotOptimize(a[0]);
+	}
+}
+
+void BenchBuildLineSegments(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	NeuronPopulation population;
+	InitPopulation(population, neurons, 20.0f, 0);
+	for (size_t i = 0; i < 16; ++i)
+		GrowPopulation(population);
+
+	std::vector<Vertex> vertices(LineVerticesPerNeuron({}) * neurons);
+	size_t              segments = 0;
+	while (state.KeepRunning())
+	{
+		segments += BuildLineSegments(population.neurons, vertices.data()) / 2;
+		DoNotOptimize(vertices[0]);
+	}
+	state.SetItemsProcessed(segments);
+}
+
+void BenchBuildCompactVertices(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	NeuronPopulation population;
+	InitPopulation(population, neurons, 20.0f, 0);
+	for (size_t i = 0; i < 16; ++i)
+		GrowPopulation(population);
+
+	NeuronShape                shape;
+	std::vector<CompactVertex> vertices(CompactVerticesPerNeuron(shape) * neurons);
+	std::vector<RenderNeuron>  renderNeurons(neurons);
+	size_t                     segments = 0;
+	while (state.KeepRunning())
+	{
+		segments += BuildCompactVertices(population.neurons, vertices.data()) / shape.points * (shape.points - 1);
+		BuildRenderNeurons(population.neurons, renderNeurons.data());
+		DoNotOptimize(vertices[0]);
+	}
+	state.SetItemsProcessed(segments);
+	state.SetLabel(std::to_string(sizeof(CompactVertex) * shape.points) + " B/dendrite vs " + std::to_string(sizeof(Vertex) * 2 * (shape.points - 1)) + " B/dendrite as lines");
+}
+
+void BenchRasterize(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	size_t           threads = static_cast<size_t>(state.Arg(1));
+	ThreadPool       pool(threads);
+	NeuronPopulation population;
+	InitPopulation(population, neurons, 20.0f, 0, pool);
+	for (size_t i = 0; i < 16; ++i)
+		GrowPopulation(population, pool);
+
+	NeuronShape    shape;
+	LineRasterizer rasterizer(1280, 720);
+	float          scaleY   = 1.0f / (10.0f * std::ceil(std::sqrt(static_cast<float>(neurons))));
+	size_t         segments = 0;
+	while (state.KeepRunning())
+	{
+		rasterizer.Render(population.neurons, { 0.0f, 0.0f }, { scaleY * 720.0f / 1280.0f, scaleY }, pool);
+		segments += neurons * shape.dendrites * (shape.points - 1);
+	}
+	state.SetItemsProcessed(segments);
+}
+
+// Grows a population for warmup steps so benchmarks start from a representative grown state. It
+// is grown anew every run, a cached copy would outlive changes to the growth code.
+void GrownPopulation(NeuronPopulation& population, size_t neurons, size_t warmup, ThreadPool& pool)
+{
+	InitPopulation(population, neurons, 20.0f, 0);
+	for (size_t i = 0; i < warmup; ++i)
+		GrowPopulation(population, pool);
+}
+
+void BenchSavePopulation(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	ThreadPool       pool(1);
+	NeuronPopulation population;
+	GrownPopulation(population, neurons, 500, pool);
+
+	std::string path  = (std::filesystem::temp_directory_path() / "ArtificialBrainBench_save.abck").string();
+	size_t      bytes = 0;
+	while (state.KeepRunning())
+	{
+		SavePopulation(path.c_str(), population);
+		bytes += std::filesystem::file_size(path);
+	}
+	std::filesystem::remove(path);
+	state.SetItemsProcessed(neurons * state.Iterations());
+	state.SetLabel(std::to_string(bytes / std::max<size_t>(state.Iterations(), 1) / neurons) + " B/neuron");
+}
+
+void BenchLoadPopulation(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	ThreadPool       pool(1);
+	NeuronPopulation population;
+	GrownPopulation(population, neurons, 500, pool);
+
+	std::string path = (std::filesystem::temp_directory_path() / "ArtificialBrainBench_load.abck").string();
+	SavePopulation(path.c_str(), population);
+	while (state.KeepRunning())
+	{
+		LoadPopulation(path.c_str(), population);
+		DoNotOptimize(population);
+	}
+	std::filesystem::remove(path);
+	state.SetItemsProcessed(neurons * state.Iterations());
+}
+
+// Small, densely packed neurons so 10^5 of them fit in memory and overlap their neighbours,
+// 16 dendrites of 8 points give 12.8M indexed points. The grid takes at most 2^24 dendrites of
+// 256 points and 2^32 - 1 points in total.
+void GridPopulation(NeuronPopulation& population, size_t neurons, ThreadPool& pool)
+{
+	InitPopulation(population, neurons, 0.5f, 0, pool, { 16, 8 });
+	for (size_t i = 0; i < 50; ++i)
+		GrowPopulation(population, pool);
+}
+
+void BenchSpatialGridBuild(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	size_t           threads = static_cast<size_t>(state.Arg(1));
+	ThreadPool       pool(threads);
+	NeuronPopulation population;
+	GridPopulation(population, neurons, pool);
+
+	SpatialGrid grid(0.05f);
+	size_t      points = 0;
+	while (state.KeepRunning())
+	{
+		grid.Build(population.neurons, pool);
+		points += grid.Size();
+	}
+	state.SetItemsProcessed(points);
+}
+
+void BenchSpatialGridRadius(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	ThreadPool       pool(1);
+	NeuronPopulation population;
+	GridPopulation(population, neurons, pool);
+	SpatialGrid grid(0.05f);
+	grid.Build(population.neurons, pool);
+
+	// Queries around dendrite tips, the contacts synapse formation looks for.
+	constexpr float c_Radius = 0.05f;
+	auto            tip      = [&](size_t query, uint32_t& neuron) {
+		neuron                  = static_cast<uint32_t>(query * 7919 % neurons);
+		const NeuronSoA& source = population.neurons[neuron];
+		size_t           i      = query % source.Dendrites();
+		return source.pos + Point { source.X(source.Points() - 1)[i], source.Y(source.Points() - 1)[i] };
+	};
+
+	// Compare a few queries against a scan over every point.
+	std::vector<GridPoint> found;
+	size_t                 mismatches = 0;
+	for (size_t query = 0; query < 4; ++query)
+	{
+		uint32_t neuron;
+		Point    center = tip(query, neuron);
+		found.clear();
+		grid.QueryRadius(center, c_Radius, found, neuron);
+
+		size_t expected = 0;
+		for (size_t n = 0; n < neurons; ++n)
+		{
+			const NeuronSoA& other = population.neurons[n];
+			for (size_t j = 0; n != neuron && j < other.Points(); ++j)
+			{
+				for (size_t i = 0; i < other.Dendrites(); ++i)
+					expected += length(other.pos + Point { other.X(j)[i], other.Y(j)[i] } - center) <= c_Radius;
+			}
+		}
+		mismatches += expected != found.size();
+	}
+
+	size_t queries = 0;
+	size_t results = 0;
+	while (state.KeepRunning())
+	{
+		for (size_t i = 0; i < 1024; ++i, ++queries)
+		{
+			uint32_t neuron;
+			Point    center = tip(queries, neuron);
+			found.clear();
+			grid.QueryRadius(center, c_Radius, found, neuron);
+			results += found.size();
+		}
+	}
+	state.SetItemsProcessed(queries);
+	state.SetError(static_cast<double>(mismatches));
+	char label[64];
+	std::snprintf(label, sizeof(label), "%.2f points/query", static_cast<double>(results) / std::max<size_t>(queries, 1));
+	state.SetLabel(label);
+}
+
+void BenchSpatialGridNearest(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	size_t           k       = static_cast<size_t>(state.Arg(1));
+	ThreadPool       pool(1);
+	NeuronPopulation population;
+	GridPopulation(population, neurons, pool);
+	SpatialGrid grid(0.05f);
+	grid.Build(population.neurons, pool);
+
+	auto tip = [&](size_t query, uint32_t& neuron) {
+		neuron                  = static_cast<uint32_t>(query * 7919 % neurons);
+		const NeuronSoA& source = population.neurons[neuron];
+		size_t           i      = query % source.Dendrites();
+		return source.pos + Point { source.X(source.Points() - 1)[i], source.Y(source.Points() - 1)[i] };
+	};
+
+	// Compare the k-th distance of a few queries against sorting every point by distance.
+	std::vector<GridPoint> found;
+	std::vector<float>     distances;
+	double                 error = 0.0;
+	for (size_t query = 0; query < 4; ++query)
+	{
+		uint32_t neuron;
+		Point    center = tip(query, neuron);
+		grid.QueryNearest(center, k, found, neuron);
+
+		distances.clear();
+		for (size_t n = 0; n < neurons; ++n)
+		{
+			const NeuronSoA& other = population.neurons[n];
+			for (size_t j = 0; n != neuron && j < other.Points(); ++j)
+			{
+				for (size_t i = 0; i < other.Dendrites(); ++i)
+					distances.push_back(length(other.pos + Point { other.X(j)[i], other.Y(j)[i] } - center));
+			}
+		}
+		std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+		error = std::max<double>(error, std::fabs(length(found.back().pos - center) - distances[k - 1]));
+	}
+
+	size_t queries = 0;
+	while (state.KeepRunning())
+	{
+		for (size_t i = 0; i < 1024; ++i, ++queries)
+		{
+			uint32_t neuron;
+			Point    center = tip(queries, neuron);
+			grid.QueryNearest(center, k, found, neuron);
+			DoNotOptimize(found);
+		}
+	}
+	state.SetItemsProcessed(queries);
+	state.SetError(error);
+}
+
+void BenchSynapseFormation(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	size_t           threads = static_cast<size_t>(state.Arg(1));
+	ThreadPool       pool(threads);
+	NeuronPopulation population;
+	GridPopulation(population, neurons, pool);
+
+	// Only the formation step is timed, growth between steps is paused. Neurons that stopped
+	// growing are settled in their own grid, so a step indexes mostly the growing ones.
+	SynapseFormation formation(0.05f);
+	size_t           tested = 0;
+	size_t           formed = 0;
+	while (state.KeepRunning())
+	{
+		formed += formation.Step(population, pool);
+		tested += formation.Tested();
+		state.PauseTiming();
+		GrowPopulation(population, pool);
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(tested);
+
+	char label[64];
+	std::snprintf(label, sizeof(label), "%.3g synapses/s", formed / state.Seconds());
+	state.SetLabel(label);
+}
+
+// Synapses from uniformly random pre neurons, synapsesPerNeuron of them onto every neuron.
+static std::vector<Synapse> RandomSynapses(size_t neurons, size_t synapsesPerNeuron, uint64_t seed)
+{
+	std::vector<Synapse> synapses(neurons * synapsesPerNeuron);
+	for (size_t s = 0; s < synapses.size(); ++s)
+	{
+		uint32_t counter[4] { static_cast<uint32_t>(s), 0, 0, 0 };
+		uint32_t bits[4];
+		Philox4x32(counter, seed, bits);
+		synapses[s] = { static_cast<uint32_t>(bits[0] % neurons), static_cast<uint32_t>(s % neurons), 0, 0, 0 };
+	}
+	return synapses;
+}
+
+template <SimdKernel Kernel>
+void BenchPropagateSignals(BenchmarkState& state)
+{
+	SetSimdKernel(Kernel);
+
+	size_t     neurons           = static_cast<size_t>(state.Arg(0));
+	size_t     synapsesPerNeuron = static_cast<size_t>(state.Arg(1));
+	size_t     threads           = static_cast<size_t>(state.Arg(2));
+	ThreadPool pool(threads);
+
+	auto          synapses = RandomSynapses(neurons, synapsesPerNeuron, 0);
+	SynapseMatrix matrix(neurons);
+	matrix.Insert(synapses.data(), synapses.size(), c_SynapseWeight);
+	matrix.Commit();
+
+	std::vector<float> activity(neurons);
+	std::vector<float> input(neurons);
+	for (size_t n = 0; n < neurons; ++n)
+	{
+		float random[4];
+		RandomUniform(0, static_cast<uint32_t>(n), 0, 0, random);
+		activity[n] = random[0] * 2.0f - 1.0f;
+	}
+
+	size_t propagated = 0;
+	while (state.KeepRunning())
+	{
+		if (threads > 1)
+			PropagateSignals(matrix, activity.data(), input.data(), pool);
+		else
+			PropagateSignals(matrix, activity.data(), input.data());
+		propagated += matrix.Size();
+		DoNotOptimize(input);
+	}
+	state.SetItemsProcessed(propagated);
+
+	std::vector<double> expected(neurons);
+	for (const Synapse& synapse : synapses)
+		expected[synapse.post] += static_cast<double>(c_SynapseWeight) * activity[synapse.pre];
+	double error = 0.0;
+	for (size_t n = 0; n < neurons; ++n)
+		error = std::max(error, std::fabs(expected[n] - input[n]));
+	state.SetError(error);
+}
+
+void BenchSynapseMatrixInsert(BenchmarkState& state)
+{
+	size_t neurons = static_cast<size_t>(state.Arg(0));
+	size_t batch   = static_cast<size_t>(state.Arg(1));
+
+	// About 1 M synapses are generated up front and replayed in batches, the matrix restarts once all are in.
+	auto   synapses  = RandomSynapses(neurons, (1 << 20) / neurons + 1, 1);
+	auto   matrix    = std::make_unique<SynapseMatrix>(neurons);
+	size_t next      = 0;
+	size_t inserted  = 0;
+	size_t moved     = 0;
+	size_t commits   = 0;
+	while (state.KeepRunning())
+	{
+		if (next + batch > synapses.size())
+		{
+			state.PauseTiming();
+			matrix = std::make_unique<SynapseMatrix>(neurons);
+			next   = 0;
+			state.ResumeTiming();
+		}
+		matrix->Insert(synapses.data() + next, batch, c_SynapseWeight);
+		moved    += matrix->Commit();
+		next     += batch;
+		inserted += batch;
+		++commits;
+	}
+	state.SetItemsProcessed(inserted);
+
+	char label[64];
+	std::snprintf(label, sizeof(label), "%.1f rows moved/commit", static_cast<double>(moved) / std::max<size_t>(commits, 1));
+	state.SetLabel(label);
+}
+
+void BenchTimingWheel(BenchmarkState& state)
+{
+	// Every due event is replaced by one with a random delay below maxDelay, so the wheel holds a
+	// steady count of events spread over all levels the delay range reaches.
+	size_t   events   = static_cast<size_t>(state.Arg(0));
+	uint32_t maxDelay = static_cast<uint32_t>(state.Arg(1));
+
+	TimingWheel             wheel;
+	std::vector<SpikeEvent> due;
+	uint32_t                counter = 0;
+	auto delay = [&]() {
+		uint32_t key[4] { counter++, 0, 0, 0 };
+		uint32_t bits[4];
+		Philox4x32(key, 0, bits);
+		return 1 + bits[0] % maxDelay;
+	};
+	for (size_t e = 0; e < events; ++e)
+		wheel.Insert({ delay(), static_cast<uint32_t>(e), 1.0f });
+
+	size_t expired = 0;
+	size_t late    = 0;
+	while (state.KeepRunning())
+	{
+		uint32_t now = wheel.Now();
+		wheel.Advance(due);
+		for (const SpikeEvent& event : due)
+		{
+			late += event.time != now;
+			wheel.Insert({ now + delay(), event.target, event.weight });
+		}
+		expired += due.size();
+	}
+	state.SetItemsProcessed(expired);
+	state.SetError(static_cast<double>(late + (wheel.Size() != events)));
+}
+
+void BenchSpikingNetwork(BenchmarkState& state)
+{
+	size_t     neurons           = static_cast<size_t>(state.Arg(0));
+	size_t     synapsesPerNeuron = static_cast<size_t>(state.Arg(1));
+	size_t     threads           = static_cast<size_t>(state.Arg(2));
+	ThreadPool pool(threads);
+
+	auto          synapses = RandomSynapses(neurons, synapsesPerNeuron, 0);
+	SynapseMatrix matrix(neurons);
+	matrix.Insert(synapses.data(), synapses.size(), 0.05f);
+	matrix.Commit();
+
+	size_t             side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(neurons))));
+	std::vector<Point> positions(neurons);
+	for (size_t n = 0; n < neurons; ++n)
+		positions[n] = { static_cast<float>(n % side) * 0.01f, static_cast<float>(n / side) * 0.01f };
+	SpikingNetwork network;
+	network.Resize(positions);
+
+	// Every simulated millisecond 1% of the neurons receive external input strong enough to fire.
+	size_t   events = 0;
+	uint32_t ms     = 0;
+	while (state.KeepRunning())
+	{
+		for (size_t i = 0; i < neurons / 100; ++i)
+		{
+			uint32_t key[4] { static_cast<uint32_t>(i), ms, 0, 0 };
+			uint32_t bits[4];
+			Philox4x32(key, 1, bits);
+			network.Stimulate(static_cast<uint32_t>(bits[0] % neurons), network.Params().threshold, bits[1] % 10);
+		}
+		events += network.Run(matrix, 10, pool);
+		++ms;
+	}
+	state.SetItemsProcessed(events);
+
+	char label[64];
+	std::snprintf(label, sizeof(label), "%.3g spikes/s", network.Spikes() / state.Seconds());
+	state.SetLabel(label);
+}
+
+// Current into every tip so the whole tree is off rest, strong enough to make an active membrane fire.
+static void StimulateTips(CableState& cable, const NeuronSoA& neuron)
+{
+	for (size_t d = 0; d < neuron.Dendrites(); ++d)
+		cable.Input(neuron.Points() - 1)[d] = 0.01f;
+}
+
+template <SimdKernel Kernel>
+void BenchStepCable(BenchmarkState& state)
+{
+	SetGrowKernel(BestSimdKernel());
+	SetGrowthMode(GrowthMode::Vector);
+
+	NeuronShape shape  = { static_cast<size_t>(state.Arg(0)), static_cast<size_t>(state.Arg(1)) };
+	CableParams params = state.Arg(2) ? ActiveCableParams() : CableParams {};
+	auto        neuron = std::make_unique<NeuronSoA>(shape);
+	InitNeuron(*neuron);
+	for (size_t i = 0; i < 200; ++i)
+		GrowNeuron(*neuron);
+
+	SetSimdKernel(Kernel);
+	CableState cable(*neuron, params);
+	StepCable(cable, *neuron, params);
+	StimulateTips(cable, *neuron);
+
+	size_t compartments = 0;
+	while (state.KeepRunning())
+	{
+		StepCable(cable, *neuron, params);
+		compartments += shape.dendrites * (shape.points - 1);
+	}
+	state.SetItemsProcessed(compartments);
+
+	// The same number of steps on the scalar kernel, the kernels only differ in rounding.
+	SetSimdKernel(SimdKernel::Scalar);
+	CableState reference(*neuron, params);
+	StepCable(reference, *neuron, params);
+	StimulateTips(reference, *neuron);
+	for (size_t i = 0; i < state.Iterations(); ++i)
+		StepCable(reference, *neuron, params);
+	double error = std::fabs(reference.soma - cable.soma);
+	for (size_t p = 0; p < shape.points; ++p)
+		for (size_t d = 0; d < shape.dendrites; ++d)
+			error = std::max<double>(error, std::fabs(reference.V(p)[d] - cable.V(p)[d]));
+	state.SetError(error);
+}
+
+void BenchStepCables(BenchmarkState& state)
+{
+	SetGrowKernel(BestSimdKernel());
+	SetGrowthMode(GrowthMode::Vector);
+	SetSimdKernel(BestSimdKernel());
+
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	size_t           threads = static_cast<size_t>(state.Arg(1));
+	ThreadPool       pool(threads);
+	NeuronPopulation population;
+	GrownPopulation(population, neurons, 500, pool);
+
+	CableParams             params;
+	std::vector<CableState> cables;
+	InitCables(cables, population, params);
+	for (size_t n = 0; n < neurons; ++n)
+		StimulateTips(cables[n], population.neurons[n]);
+
+	const NeuronShape shape        = population.neurons[0].Shape();
+	size_t            compartments = 0;
+	while (state.KeepRunning())
+	{
+		StepCables(cables, population, params, pool);
+		compartments += neurons * shape.dendrites * (shape.points - 1);
+	}
+	state.SetItemsProcessed(compartments);
+}
+
+void BenchInitPopulation(BenchmarkState& state)
+{
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	size_t           threads = static_cast<size_t>(state.Arg(1));
+	NeuronShape      shape   = { static_cast<size_t>(state.Arg(2)), static_cast<size_t>(state.Arg(3)) };
+	ThreadPool       pool(threads);
+	NeuronPopulation population;
+
+	while (state.KeepRunning())
+	{
+		if (threads > 1)
+			InitPopulation(population, neurons, 20.0f, 0, pool, shape);
+		else
+			InitPopulation(population, neurons, 20.0f, 0, shape);
+		DoNotOptimize(population);
+	}
+	state.SetItemsProcessed(neurons * state.Iterations());
+}
+
+void BenchGrowPopulation(BenchmarkState& state)
+{
+	SetGrowKernel(BestSimdKernel());
+	SetGrowthMode(GrowthMode::Vector);
+
+	size_t           neurons = static_cast<size_t>(state.Arg(0));
+	size_t           threads = static_cast<size_t>(state.Arg(1));
+	ThreadPool       pool(threads);
+	NeuronPopulation population;
+	GrownPopulation(population, neurons, static_cast<size_t>(state.Arg(2)), pool);
+
+	NeuronPopulation grown    = population;
+	size_t           segments = 0;
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		population = grown;
+		state.ResumeTiming();
+		for (size_t i = 0; i < c_PopulationWindow; ++i)
+			segments += threads > 1 ? GrowPopulation(population, pool) : GrowPopulation(population);
+	}
+	state.SetItemsProcessed(segments);
+}
+
+template <GrowthMode Mode, SimdKernel Kernel>
+void RegisterKernelBenchmarks()
+{
+	if (!IsSimdKernelSupported(Kernel))
+		return;
+	std::string suffix = std::string("/") + GrowthModeName(Mode) + "/" + SimdKernelName(Kernel);
+	RegisterBenchmark("GrowNeuron/SoA" + suffix, &BenchGrowNeuronSoA<Mode, Kernel>);
+	RegisterBenchmark("GrowNeurites" + suffix, &BenchGrowNeurites<Mode, Kernel>, { { 8, 32 }, { 64, 32 }, { 256, 32 }, { 64, 8 }, { 1024, 64 } });
+}
+
+template <SimdKernel Kernel>
+void RegisterPropagateBenchmarks()
+{
+	if (!IsSimdKernelSupported(Kernel))
+		return;
+	std::vector<std::vector<int64_t>> args = { { 100000, 16, 1 }, { 100000, 256, 1 } };
+	for (size_t threads = 2; threads <= std::max<size_t>(std::thread::hardware_concurrency(), 1); threads *= 2)
+		args.push_back({ 100000, 256, static_cast<int64_t>(threads) });
+	RegisterBenchmark(std::string("PropagateSignals/") + SimdKernelName(Kernel), &BenchPropagateSignals<Kernel>, args);
+}
+
+template <SimdKernel Kernel>
+void RegisterCableBenchmarks()
+{
+	if (!IsSimdKernelSupported(Kernel))
+		return;
+	RegisterBenchmark(std::string("StepCable/") + SimdKernelName(Kernel), &BenchStepCable<Kernel>, { { 64, 8, 0 }, { 256, 32, 0 }, { 256, 32, 1 }, { 1024, 64, 0 } });
+}
+
+template <GrowthMode Mode>
+void RegisterModeBenchmarks()
+{
+	std::string suffix = std::string("/") + GrowthModeName(Mode);
+	RegisterBenchmark("GrowNeurite<8>" + suffix, &BenchGrowNeurite<8, Mode>);
+	RegisterBenchmark("GrowNeurite<16>" + suffix, &BenchGrowNeurite<16, Mode>);
+	RegisterBenchmark("GrowNeurite<32>" + suffix, &BenchGrowNeurite<32, Mode>);
+	RegisterBenchmark("GrowNeurite<64>" + suffix, &BenchGrowNeurite<64, Mode>);
+	RegisterKernelBenchmarks<Mode, SimdKernel::Scalar>();
+	RegisterKernelBenchmarks<Mode, SimdKernel::SSE41>();
+	RegisterKernelBenchmarks<Mode, SimdKernel::AVX2>();
+	RegisterKernelBenchmarks<Mode, SimdKernel::AVX512>();
+}
+
+int main(int argc, char** argv)
+{
+	RegisterBenchmark("PointOperators/inline", &BenchPointOperators<Point>, { { 256 }, { 4096 } });
+	RegisterBenchmark("PointOperators/outOfLine", &BenchPointOperators<OutOfLinePoint>, { { 256 }, { 4096 } });
+	RegisterBenchmark("InitNeuron/AoS", &BenchInitNeuron<Neuron>);
+	RegisterBenchmark("InitNeuron/AoS<64,8>", &BenchInitNeuron<NeuronT<64, 8>>);
+	RegisterBenchmark("InitNeuron/AoS<1024,64>", &BenchInitNeuron<NeuronT<1024, 64>>);
+	RegisterBenchmark("InitNeuron/SoA", &BenchInitNeuron<NeuronSoA>);
+	RegisterBenchmark("GrowNeuron/AoS", &BenchGrowNeuron<Neuron>);
+	RegisterBenchmark("GrowNeuron/AoS<64,8>", &BenchGrowNeuron<NeuronT<64, 8>>);
+	RegisterBenchmark("GrowNeuron/AoS<1024,64>", &BenchGrowNeuron<NeuronT<1024, 64>>);
+	RegisterBenchmark("GrowNeuron/SoA/shape", &BenchGrowNeuronShape, { { 64, 8 }, { 256, 32 }, { 1024, 64 } });
+	RegisterBenchmark("GrowNeuron/AoS/grown", &BenchGrowNeuronGrown<Neuron>, { { 0 }, { 1000 }, { 4000 } });
+	RegisterBenchmark("GrowNeuron/SoA/grown", &BenchGrowNeuronGrown<NeuronSoA>, { { 0 }, { 1000 }, { 4000 } });
+	RegisterModeBenchmarks<GrowthMode::Trig>();
+	RegisterModeBenchmarks<GrowthMode::Vector>();
+	RegisterBenchmark("BuildLineSegments", &BenchBuildLineSegments, { { 1 }, { 16 }, { 64 } });
+	RegisterBenchmark("BuildCompactVertices", &BenchBuildCompactVertices, { { 1 }, { 16 }, { 64 } });
+
+	std::vector<std::vector<int64_t>> populationArgs;
+	for (size_t threads = 1; threads <= std::max<size_t>(std::thread::hardware_concurrency(), 1); threads *= 2)
+		populationArgs.push_back({ 64, static_cast<int64_t>(threads), 0 });
+	populationArgs.push_back({ 64, 1, 500 });
+	populationArgs.push_back({ 64, 1, 1000 });
+	RegisterBenchmark("GrowPopulation", &BenchGrowPopulation, populationArgs);
+
+	std::vector<std::vector<int64_t>> initArgs;
+	for (size_t threads = 1; threads <= std::max<size_t>(std::thread::hardware_concurrency(), 1); threads *= 2)
+	{
+		initArgs.push_back({ 4096, static_cast<int64_t>(threads), 256, 32 });
+		initArgs.push_back({ 65536, static_cast<int64_t>(threads), 64, 8 });
+	}
+	RegisterBenchmark("InitPopulation", &BenchInitPopulation, initArgs);
+	RegisterBenchmark("SavePopulation", &BenchSavePopulation, { { 64 } });
+	RegisterBenchmark("LoadPopulation", &BenchLoadPopulation, { { 64 } });
+
+	std::vector<std::vector<int64_t>> rasterizeArgs;
+	for (size_t threads = 1; threads <= std::max<size_t>(std::thread::hardware_concurrency(), 1); threads *= 2)
+	{
+		rasterizeArgs.push_back({ 16, static_cast<int64_t>(threads) });
+		rasterizeArgs.push_back({ 256, static_cast<int64_t>(threads) });
+	}
+	RegisterBenchmark("Rasterize", &BenchRasterize, rasterizeArgs);
+
+	std::vector<std::vector<int64_t>> gridArgs;
+	for (size_t threads = 1; threads <= std::max<size_t>(std::thread::hardware_concurrency(), 1); threads *= 2)
+		gridArgs.push_back({ 100000, static_cast<int64_t>(threads) });
+	RegisterBenchmark("SpatialGrid/Build", &BenchSpatialGridBuild, gridArgs);
+	RegisterBenchmark("SpatialGrid/Radius", &BenchSpatialGridRadius, { { 100000 } });
+	RegisterBenchmark("SpatialGrid/Nearest", &BenchSpatialGridNearest, { { 100000, 1 }, { 100000, 16 } });
+	RegisterBenchmark("SynapseFormation", &BenchSynapseFormation, gridArgs);
+	RegisterPropagateBenchmarks<SimdKernel::Scalar>();
+	RegisterPropagateBenchmarks<SimdKernel::SSE41>();
+	RegisterPropagateBenchmarks<SimdKernel::AVX2>();
+	RegisterPropagateBenchmarks<SimdKernel::AVX512>();
+	RegisterBenchmark("SynapseMatrix/Insert", &BenchSynapseMatrixInsert, { { 100000, 1024 }, { 100000, 65536 } });
+	RegisterBenchmark("TimingWheel", &BenchTimingWheel, { { 10000, 200 }, { 1000000, 200 }, { 1000000, 100000 } });
+
+	std::vector<std::vector<int64_t>> spikingArgs;
+	for (size_t threads = 1; threads <= std::max<size_t>(std::thread::hardware_concurrency(), 1); threads *= 2)
+		spikingArgs.push_back({ 100000, 100, static_cast<int64_t>(threads) });
+	RegisterBenchmark("SpikingNetwork", &BenchSpikingNetwork, spikingArgs);
+
+	RegisterCableBenchmarks<SimdKernel::Scalar>();
+	RegisterCableBenchmarks<SimdKernel::SSE41>();
+	RegisterCableBenchmarks<SimdKernel::AVX2>();
+	RegisterCableBenchmarks<SimdKernel::AVX512>();
+	std::vector<std::vector<int64_t>> cableArgs;
+	for (size_t threads = 1; threads <= std::max<size_t>(std::thread::hardware_concurrency(), 1); threads *= 2)
+		cableArgs.push_back({ 64, static_cast<int64_t>(threads) });
+	RegisterBenchmark("StepCables", &BenchStepCables, cableArgs);
+
+	return RunBenchmarks(argc, argv);
+}
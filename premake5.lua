@@ -8,6 +8,21 @@ workspace("ArtificialBrain")
 	flags("MultiProcessorCompile")
 
 	startproject("ArtificialBrain")
+
+	filter({ "files:**/GrowKernelSSE41.cpp", "toolset:not msc*" })
+		buildoptions({ "-msse4.1" })
+	filter({ "files:**/GrowKernelAVX2.cpp", "toolset:msc*" })
+		buildoptions({ "/arch:AVX2" })
+	filter({ "files:**/GrowKernelAVX2.cpp", "toolset:not msc*" })
+		buildoptions({ "-mavx2", "-mfma", "-ffp-contract=off" })
+	filter({ "files:**/GrowKernelAVX512.cpp", "toolset:msc*" })
+		buildoptions({ "/arch:AVX512" })
+	filter({ "files:**/GrowKernelAVX512.cpp", "toolset:not msc*" })
+		buildoptions({ "-mavx512f", "-mfma", "-ffp-contract=off" })
+	filter("system:linux")
+		links({ "pthread" })
+	filter({})
+
 	project("glad")
 		location("glad/")
 		warnings("Off")
@@ -44,4 +59,43 @@ workspace("ArtificialBrain")
 
 		pkgdeps({ "commonbuild", "backtrace", "glfw" })
 
+		common:addActions()
+
+	project("ArtificialBrainBench")
+		location("ArtificialBrainBench/")
+		warnings("Extra")
+
+		common:outDirs()
+		common:debugDir()
+
+		kind("ConsoleApp")
+
+		includedirs({
+			"%{prj.location}/Src/",
+			"%{wks.location}/ArtificialBrain/Src/"
+		})
+		files({
+			"%{prj.location}/Src/**",
+			"%{wks.location}/ArtificialBrain/Src/Brain.*",
+			"%{wks.location}/ArtificialBrain/Src/Cable.*",
+			"%{wks.location}/ArtificialBrain/Src/CableKernel.h",
+			"%{wks.location}/ArtificialBrain/Src/Checkpoint.*",
+			"%{wks.location}/ArtificialBrain/Src/GrowKernel*",
+			"%{wks.location}/ArtificialBrain/Src/Random.*",
+			"%{wks.location}/ArtificialBrain/Src/Rasterizer.*",
+			"%{wks.location}/ArtificialBrain/Src/Simd.*",
+			"%{wks.location}/ArtificialBrain/Src/Simulation.*",
+			"%{wks.location}/ArtificialBrain/Src/SpatialGrid.*",
+			"%{wks.location}/ArtificialBrain/Src/Spiking.*",
+			"%{wks.location}/ArtificialBrain/Src/SynapseKernel.h",
+			"%{wks.location}/ArtificialBrain/Src/SynapseMatrix.*",
+			"%{wks.location}/ArtificialBrain/Src/Synapses.*",
+			"%{wks.location}/ArtificialBrain/Src/TripleBuffer.h",
+			"%{wks.location}/ArtificialBrain/Src/ThreadPool.*",
+			"%{wks.location}/ArtificialBrain/Src/Vertices.*"
+		})
+		removefiles({ "*.DS_Store" })
+
+		pkgdeps({ "commonbuild", "backtrace" })
+
 		common:addActions()
\ No newline at end of file